@@ -0,0 +1,127 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <vector>
+
+#include <common/allocators/ChainedPool.h>
+#include <common/CapricaReportingContext.h>
+
+namespace caprica {
+
+// A pointer to something in the same ContiguousArena as the pointer itself,
+// stored as a 32-bit offset from the pointer's own address, with 0 being null.
+// It only makes sense where it lives, so it can be assigned, but not copied
+// out to somewhere else; take the plain pointer with get() instead.
+template <typename T>
+struct ArenaPtr final {
+  ArenaPtr() = default;
+  ArenaPtr(std::nullptr_t) { }
+  ArenaPtr(const ArenaPtr&) = delete;
+  ~ArenaPtr() = default;
+
+  ArenaPtr& operator=(T* p) {
+    set(p);
+    return *this;
+  }
+  ArenaPtr& operator=(const ArenaPtr& other) {
+    set(other.get());
+    return *this;
+  }
+
+  T* get() const { return offset ? (T*)((const char*)this + offset) : nullptr; }
+  operator T*() const { return get(); }
+  T* operator->() const { return get(); }
+
+private:
+  int32_t offset { 0 };
+
+  void set(T* p) {
+    if (!p) {
+      offset = 0;
+      return;
+    }
+    auto diff = (const char*)p - (const char*)this;
+    if (diff != (int32_t)diff)
+      CapricaReportingContext::logicalFatal("An ArenaPtr was pointed at something outside of its arena!");
+    offset = (int32_t)diff;
+  }
+};
+static_assert(sizeof(ArenaPtr<int>) == 4, "An ArenaPtr should only be an offset");
+
+// A fixed list of pointers to things in the same ContiguousArena, laid out
+// one after the other in that arena. It only holds an offset and a count,
+// and the elements are ArenaPtrs themselves, so a list costs 8 bytes plus 4
+// for each element, with nothing kept in the elements for the list's sake.
+template <typename T>
+struct ArenaSpan final {
+  ArenaSpan() = default;
+  ArenaSpan(const ArenaSpan&) = delete;
+  ArenaSpan& operator=(const ArenaSpan&) = delete;
+  ~ArenaSpan() = default;
+
+  struct Iterator final {
+    T* operator*() const { return *cur; }
+    Iterator& operator++() {
+      cur++;
+      return *this;
+    }
+    bool operator==(const Iterator& other) const { return cur == other.cur; }
+    bool operator!=(const Iterator& other) const { return cur != other.cur; }
+
+  private:
+    friend ArenaSpan;
+    const ArenaPtr<T>* cur;
+
+    explicit Iterator(const ArenaPtr<T>* c) : cur(c) { }
+  };
+
+  Iterator begin() const { return Iterator(items.get()); }
+  Iterator end() const { return Iterator(items.get() + count); }
+
+  size_t size() const { return count; }
+  bool empty() const { return count == 0; }
+  T* front() const { return items.get()[0]; }
+  T* back() const { return items.get()[count - 1]; }
+  T* operator[](size_t i) const { return items.get()[i]; }
+
+  // Replaces the list with a copy of the given pointers, allocated from alloc,
+  // which has to take its heaps from the same arena as this span lives in.
+  void assign(allocators::ChainedPool* alloc, T* const* values, size_t valueCount) {
+    if (valueCount != (uint32_t)valueCount)
+      CapricaReportingContext::logicalFatal("Too many elements for an ArenaSpan!");
+    if (!valueCount) {
+      items = nullptr;
+      count = 0;
+      return;
+    }
+    auto buf = (ArenaPtr<T>*)alloc->allocate(sizeof(ArenaPtr<T>) * valueCount);
+    for (size_t i = 0; i < valueCount; i++) {
+      new (&buf[i]) ArenaPtr<T>();
+      buf[i] = values[i];
+    }
+    items = buf;
+    count = (uint32_t)valueCount;
+  }
+  void assign(allocators::ChainedPool* alloc, const std::vector<T*>& values) {
+    assign(alloc, values.data(), values.size());
+  }
+
+  // Appends val by copying the list; for the rare case where a list grows after it was built.
+  void push_back(allocators::ChainedPool* alloc, T* val) {
+    std::vector<T*> values {};
+    values.reserve(count + 1);
+    for (auto v : *this)
+      values.push_back(v);
+    values.push_back(val);
+    assign(alloc, values);
+  }
+
+private:
+  ArenaPtr<ArenaPtr<T>> items {};
+  uint32_t count { 0 };
+};
+static_assert(sizeof(ArenaSpan<int>) == 8, "An ArenaSpan should only be an offset and a count");
+
+}
@@ -2,25 +2,25 @@
 
 #include <common/ByteSwap.h>
 #include <cstdint>
-#include <fstream>
-#include <iostream>
-#include <memory>
+#include <cstring>
 #include <string>
+#include <string_view>
+
+#include <common/CapricaReportingContext.h>
 
 namespace caprica {
 
+// Reads from a buffer that is already in memory, rather than going to the
+// file for every field. Strings are returned as views into the buffer, so
+// the buffer has to outlive anything that holds on to them.
 struct CapricaBinaryReader {
   Endianness endianness { Endianness::Little };
-  explicit CapricaBinaryReader(const std::string& file) : strm(file, std::ifstream::binary) {
-    strm.exceptions(std::ifstream::badbit | std::ifstream::failbit);
-  }
+  explicit CapricaBinaryReader(std::string_view buffer) : data(buffer) { }
   CapricaBinaryReader(const CapricaBinaryReader&) = delete;
   ~CapricaBinaryReader() = default;
 
-  bool eof() {
-    strm.peek();
-    return strm.eof();
-  }
+  bool eof() const { return position >= data.size(); }
+  void skip(size_t size) { take(size); }
 
   template <typename T>
   T read() {
@@ -29,71 +29,88 @@ struct CapricaBinaryReader {
 
   template <>
   int8_t read() {
-    int8_t val;
-    strm.read((char*)&val, sizeof(val));
-    return endianness == Endianness::Little ? val : byteswap(val);
+    return readScalar<int8_t>();
   }
 
   template <>
   uint8_t read() {
-    uint8_t val = 0;
-    strm.read((char*)&val, sizeof(val));
-    return endianness == Endianness::Little ? val : byteswap(val);
+    return readScalar<uint8_t>();
   }
 
   template <>
   int16_t read() {
-    int16_t val;
-    strm.read((char*)&val, sizeof(val));
-    return endianness == Endianness::Little ? val : byteswap(val);
+    return readScalar<int16_t>();
   }
 
   template <>
   uint16_t read() {
-    uint16_t val;
-    strm.read((char*)&val, sizeof(val));
-    return endianness == Endianness::Little ? val : byteswap(val);
+    return readScalar<uint16_t>();
   }
 
   template <>
   int32_t read() {
-    int32_t val;
-    strm.read((char*)&val, sizeof(val));
-    return endianness == Endianness::Little ? val : byteswap(val);
+    return readScalar<int32_t>();
   }
 
   template <>
   uint32_t read() {
-    uint32_t val;
-    strm.read((char*)&val, sizeof(val));
-    return endianness == Endianness::Little ? val : byteswap(val);
+    return readScalar<uint32_t>();
   }
 
   template <>
   float read() {
+    auto bits = readScalar<uint32_t>();
     float val;
-    strm.read((char*)&val, sizeof(val));
-    return endianness == Endianness::Little ? val : byteswap_float(val);
+    memcpy(&val, &bits, sizeof(val));
+    return val;
   }
 
   template <>
   time_t read() {
     static_assert(sizeof(time_t) == 8, "time_t is not 64 bits");
-    time_t val;
-    strm.read((char*)&val, sizeof(val));
-    return endianness == Endianness::Little ? val : byteswap(val);
+    return readScalar<time_t>();
   }
 
   template <>
-  std::string read() {
+  std::string_view read() {
     auto len = read<uint16_t>();
-    std::unique_ptr<char[]> buf(new char[len]);
-    strm.read(buf.get(), len);
-    return std::string(buf.get(), buf.get() + len);
+    return std::string_view(take(len), len);
+  }
+
+  template <>
+  std::string read() {
+    return std::string(read<std::string_view>());
+  }
+
+  // Reads `count` values in one go, then fixes up their endianness.
+  template <typename T>
+  void readArray(T* dest, size_t count) {
+    static_assert(std::is_integral_v<T>, "Only arrays of integers can be read in bulk!");
+    memcpy(dest, take(count * sizeof(T)), count * sizeof(T));
+    if (endianness == Endianness::Big) {
+      for (size_t i = 0; i < count; i++)
+        dest[i] = byteswap(dest[i]);
+    }
   }
 
 protected:
-  std::ifstream strm;
+  std::string_view data;
+  size_t position { 0 };
+
+  const char* take(size_t size) {
+    if (size > data.size() - position)
+      CapricaReportingContext::logicalFatal("Unexpected end of file, the file is truncated or corrupt!");
+    auto ptr = data.data() + position;
+    position += size;
+    return ptr;
+  }
+
+  template <typename T>
+  T readScalar() {
+    T val;
+    memcpy(&val, take(sizeof(T)), sizeof(T));
+    return endianness == Endianness::Little ? val : byteswap(val);
+  }
 };
 
 }
@@ -2,25 +2,58 @@
 
 #include <cassert>
 #include <cstdint>
+#include <cstdlib>
+#include <cstring>
 #include <limits>
 #include <string_view>
 
-#include <common/allocators/ChainedPool.h>
 #include <common/ByteSwap.h>
+#include <common/CapricaMemoryReport.h>
+#include <common/CapricaReportingContext.h>
 #include <common/FSUtils.h>
 
 namespace caprica {
 
 struct CapricaBinaryWriter {
   Endianness endianness { Endianness::Little };
-  explicit CapricaBinaryWriter() = default;
+  explicit CapricaBinaryWriter(MemoryOwner memOwner = MemoryOwner::Unknown) : owner(memOwner) { }
   CapricaBinaryWriter(const CapricaBinaryWriter&) = delete;
-  ~CapricaBinaryWriter() = default;
+  ~CapricaBinaryWriter() {
+    free(buffer);
+    if (reportedCapacity)
+      CapricaMemoryReport::freed(owner, reportedCapacity);
+  }
+
+  void reset() {
+    endianness = Endianness::Little;
+    bufferLength = 0;
+    measuring = false;
+  }
+
+  // The output is built in a single contiguous buffer, which is kept
+  // across reset() so a reused writer rarely has to grow it.
+  const char* data() const { return buffer; }
+  size_t size() const { return bufferLength; }
 
-  template <typename F>
-  void applyToBuffers(F&& func) {
-    for (auto beg = strm.begin(), end = strm.end(); beg != end; ++beg)
-      func(beg.data(), beg.size());
+  void reserve(size_t size) {
+    if (size > bufferCapacity)
+      grow(size);
+  }
+
+  // While measuring, writes only count how much they would have written, so
+  // the output can be measured first and the buffer allocated once for it.
+  void beginMeasuring() {
+    assert(!measuring);
+    measuring = true;
+    measureStart = bufferLength;
+  }
+  // Returns the size the buffer needs to be to hold what was measured.
+  size_t endMeasuring() {
+    assert(measuring);
+    measuring = false;
+    auto measured = bufferLength;
+    bufferLength = measureStart;
+    return measured;
   }
 
   template <typename T>
@@ -36,43 +69,43 @@ struct CapricaBinaryWriter {
 
   template <>
   void write(int8_t val) {
-    strm.make<int8_t>(val);
+    put<int8_t>(val);
   }
 
   template <>
   void write(uint8_t val) {
-    strm.make<uint8_t>(val);
+    put<uint8_t>(val);
   }
 
   template <>
   void write(int16_t val) {
-    strm.make<int16_t>(endianness == Endianness::Little ? val : byteswap(val));
+    put<int16_t>(endianness == Endianness::Little ? val : byteswap(val));
   }
 
   template <>
   void write(uint16_t val) {
-    strm.make<uint16_t>(endianness == Endianness::Little ? val : byteswap(val));
+    put<uint16_t>(endianness == Endianness::Little ? val : byteswap(val));
   }
 
   template <>
   void write(int32_t val) {
-    strm.make<int32_t>(endianness == Endianness::Little ? val : byteswap(val));
+    put<int32_t>(endianness == Endianness::Little ? val : byteswap(val));
   }
 
   template <>
   void write(uint32_t val) {
-    strm.make<uint32_t>(endianness == Endianness::Little ? val : byteswap(val));
+    put<uint32_t>(endianness == Endianness::Little ? val : byteswap(val));
   }
 
   template <>
   void write(float val) {
-    strm.make<float>(endianness == Endianness::Little ? val : byteswap_float(val));
+    put<float>(endianness == Endianness::Little ? val : byteswap_float(val));
   }
 
   template <>
   void write(time_t val) {
     static_assert(sizeof(time_t) == 8, "time_t is not 64 bits");
-    strm.make<time_t>(endianness == Endianness::Little ? val : byteswap(val));
+    put<time_t>(endianness == Endianness::Little ? val : byteswap(val));
   }
 
   template <>
@@ -90,12 +123,53 @@ struct CapricaBinaryWriter {
   }
 
 protected:
-  allocators::ChainedPool strm { 1024 * 4 };
+  char* buffer { nullptr };
+  size_t bufferLength { 0 };
+  size_t bufferCapacity { 0 };
+  bool measuring { false };
+  size_t measureStart { 0 };
+
+  char* allocate(size_t size) {
+    if (bufferLength + size > bufferCapacity)
+      grow(bufferLength + size);
+    auto ret = buffer + bufferLength;
+    bufferLength += size;
+    return ret;
+  }
+
+  template <typename T>
+  void put(T val) {
+    if (measuring)
+      bufferLength += sizeof(T);
+    else
+      memcpy(allocate(sizeof(T)), &val, sizeof(T));
+  }
 
   void append(const char* __restrict a, size_t size) {
-    // ChainedPool will re-order large allocations, so disallow them.
-    assert(size < 4096);
-    memcpy(strm.allocate(size), a, size);
+    if (measuring)
+      bufferLength += size;
+    else
+      memcpy(allocate(size), a, size);
+  }
+
+private:
+  MemoryOwner owner;
+  // How much of the buffer has been reported to the memory report.
+  size_t reportedCapacity { 0 };
+
+  void grow(size_t minCapacity) {
+    auto newCapacity = bufferCapacity ? bufferCapacity : 1024 * 16;
+    while (newCapacity < minCapacity)
+      newCapacity *= 2;
+    auto newBuffer = (char*)realloc(buffer, newCapacity);
+    if (!newBuffer)
+      CapricaReportingContext::logicalFatal("Failed to grow the output buffer to %zu bytes!", newCapacity);
+    buffer = newBuffer;
+    bufferCapacity = newCapacity;
+    if (CapricaMemoryReport::enabled()) {
+      CapricaMemoryReport::allocated(owner, newCapacity - reportedCapacity);
+      reportedCapacity = newCapacity;
+    }
   }
 };
 
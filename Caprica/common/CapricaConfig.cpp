@@ -8,6 +8,10 @@ namespace caprica { namespace conf {
 namespace General {
   bool compileInParallel{ false };
   bool quietCompile{ false };
+  DiagnosticsFormat diagnosticsFormat{ DiagnosticsFormat::Text };
+  std::string diagnosticsOutputFile{ };
+  bool transformPex{ false };
+  bool checkOnly{ false };
 }
 
 namespace CodeGeneration {
@@ -15,7 +19,11 @@ namespace CodeGeneration {
   bool disableDebugCode{ false };
   bool enableCKOptimizations{ false };
   bool enableOptimizations{ false };
+  bool forceEnableOptimizations{ false };
   bool emitDebugInfo{ false };
+  bool stripUserInfo{ false };
+  bool reproducible{ false };
+  time_t reproducibleTimestamp{ 0 };
 }
 
 namespace Debug {
@@ -47,6 +55,7 @@ namespace Papyrus {
   bool ignorePropertyNameLocalConflicts{ false };
   bool allowImplicitNoneCastsToAnyType{ false };
   std::vector<std::string> importDirectories{ };
+  bool importPexFiles{ false };
   CapricaUserFlagsDefinition userFlagsDefinition{ };
 }
 
@@ -62,8 +71,10 @@ namespace Performance {
   bool asyncFileRead{ false };
   bool asyncFileWrite{ false };
   bool dumpTiming{ false };
+  bool memoryReport{ false };
   bool performanceTestMode{ false };
   bool resolveSymlinks{ false };
+  std::string traceOutputFile{ };
 }
 
 namespace Warnings {
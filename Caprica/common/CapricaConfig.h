@@ -1,6 +1,7 @@
 #pragma once
 
 #include <cstdint>
+#include <ctime>
 #include <string>
 #include <unordered_set>
 #include <vector>
@@ -17,6 +18,23 @@ namespace General {
   extern bool compileInParallel;
   // If true, only report failures, not progress.
   extern bool quietCompile;
+
+  enum class DiagnosticsFormat {
+    Text,
+    Json,
+    Sarif,
+  };
+  // The format to additionally write errors and warnings
+  // in. Text means only the normal console output is done.
+  extern DiagnosticsFormat diagnosticsFormat;
+  // The file to write the structured diagnostics to.
+  extern std::string diagnosticsOutputFile;
+  // If true, the input files are compiled .pex files, which are
+  // optimized and stripped and then written back out.
+  extern bool transformPex;
+  // If true, the input files are only checked for errors,
+  // and nothing is generated or written for them.
+  extern bool checkOnly;
 }
 
 // Options related to code generation.
@@ -31,8 +49,19 @@ namespace CodeGeneration {
   // Enable optimizations normally enabled by the -optimize switch to the
   // CK compiler.
   extern bool enableOptimizations;
+  // If true, optimizations are done even for games
+  // other than Fallout 4, which they aren't tested on.
+  extern bool forceEnableOptimizations;
   // If true, emit debug info for the papyrus script.
   extern bool emitDebugInfo;
+  // If true, leave the user and computer names out of the compiled script.
+  extern bool stripUserInfo;
+  // If true, the output only depends on the input, so compiling the same
+  // sources always produces the same bytes. Implies stripUserInfo.
+  extern bool reproducible;
+  // The compilation and modification time written in reproducible mode,
+  // taken from SOURCE_DATE_EPOCH if it is set.
+  extern time_t reproducibleTimestamp;
 }
 
 // Options related to debugging Caprica itself.
@@ -95,6 +124,9 @@ namespace Papyrus {
   // The directories to search in for imported types and
   // unknown types.
   extern std::vector<std::string> importDirectories;
+  // Also import the compiled .pex files in the import directories,
+  // for scripts whose source isn't next to them.
+  extern bool importPexFiles;
   // The user flags definition.
   extern CapricaUserFlagsDefinition userFlagsDefinition;
 }
@@ -118,7 +150,8 @@ namespace Performance {
   // If true, read files asyncronously in an attempt to pre-emptively
   // read them from disk. This results in worse performance on HDDs,
   // but better performance on SSDs, as they are actually able to read
-  // multiple files at once.
+  // multiple files at once. If false, imports are only read once
+  // something refers to them.
   extern bool asyncFileRead;
   // If true, write files to disk on background threads, allowing
   // the main compile threads to keep working while waiting for the
@@ -126,6 +159,9 @@ namespace Performance {
   extern bool asyncFileWrite;
   // If true, output timing stats.
   extern bool dumpTiming;
+  // If true, track the memory used by the compiler's allocators
+  // and report it once compilation has finished.
+  extern bool memoryReport;
   // If true, we pause and wait for all files to be read in before
   // compiling them, and we also don't write them out to disk.
   // This is done to increase the consistency of the test runs.
@@ -133,6 +169,9 @@ namespace Performance {
   // If true, resolve symlinks while building canonical
   // paths.
   extern bool resolveSymlinks;
+  // If not empty, the file to write a Chrome trace of
+  // the compile to.
+  extern std::string traceOutputFile;
 }
 
 // Options related to warnings.
@@ -1,15 +1,23 @@
 #pragma once
 
+#include <cassert>
+#include <cstddef>
 #include <cstdint>
+#include <limits>
 
 namespace caprica {
 
+// An offset into a source file. It's kept to 32 bits, as every AST node
+// carries one, so a file being parsed is limited to 4GB.
 struct CapricaFileLocation final {
-  size_t fileOffset { 0 };
+  uint32_t fileOffset { 0 };
 
   explicit CapricaFileLocation() = default;
-  explicit CapricaFileLocation(size_t offset) noexcept : fileOffset(offset) { }
+  explicit CapricaFileLocation(size_t offset) noexcept : fileOffset((uint32_t)offset) {
+    assert(offset <= std::numeric_limits<uint32_t>::max());
+  }
   ~CapricaFileLocation() = default;
 };
+static_assert(sizeof(CapricaFileLocation) == 4, "CapricaFileLocation should be 32 bits");
 
 }
@@ -1,11 +1,13 @@
 #include <common/CapricaJobManager.h>
 
 #include <common/CapricaReportingContext.h>
+#include <common/CapricaTrace.h>
 
 namespace caprica {
 
 void CapricaJob::await() {
   if (!tryRun()) {
+    CapricaTrace::Scope trace { CapricaTrace::Category::Blocked, "Await" };
     std::unique_lock<std::mutex> ranLock { ranMutex };
     ranCondition.wait(ranLock, [this] { return hasRan.load(std::memory_order_consume); });
   }
@@ -120,6 +122,7 @@ StartOver:
   }
 
   {
+    CapricaTrace::Scope trace { CapricaTrace::Category::Idle, "Idle" };
     std::unique_lock<std::mutex> lk { notARealMutex };
     waiterCount++;
     queueCondition.wait_for(lk, std::chrono::milliseconds(100), waitCallback);
@@ -0,0 +1,138 @@
+#include <common/CapricaMemoryReport.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <mutex>
+#include <vector>
+
+#include <Windows.h>
+#include <psapi.h>
+
+#include <common/CapricaConfig.h>
+
+namespace caprica {
+
+namespace {
+
+constexpr size_t OwnerCount = (size_t)MemoryOwner::Count;
+constexpr size_t PhaseCount = (size_t)CapricaMemoryReport::Phase::Count;
+constexpr size_t LargestScriptCount = 10;
+
+constexpr const char* ownerNames[OwnerCount] = {
+  "Other", "Read buffers", "Script ASTs", "PexFiles", "PexWriter streams", "String pools",
+};
+constexpr const char* phaseNames[PhaseCount] = {
+  "Other", "Read", "Parse", "Semantic", "Compile", "Write",
+};
+
+struct ScriptRecord final {
+  std::string name {};
+  size_t astBytes { 0 };
+  size_t pexBytes { 0 };
+  size_t outputBytes { 0 };
+};
+
+std::atomic<size_t> totalBytes { 0 };
+std::atomic<size_t> totalHighWater { 0 };
+std::atomic<size_t> ownerBytes[OwnerCount] {};
+std::atomic<size_t> ownerHighWater[OwnerCount] {};
+std::atomic<size_t> phaseHighWater[PhaseCount] {};
+
+std::mutex scriptsMutex {};
+// Guarded by scriptsMutex.
+std::vector<ScriptRecord> scripts {};
+
+thread_local CapricaMemoryReport::Phase currentPhase { CapricaMemoryReport::Phase::Other };
+
+void updateMax(std::atomic<size_t>& highWater, size_t val) {
+  auto cur = highWater.load(std::memory_order_relaxed);
+  while (val > cur && !highWater.compare_exchange_weak(cur, val, std::memory_order_relaxed)) {
+  }
+}
+
+double toMB(size_t bytes) {
+  return (double)bytes / (1024 * 1024);
+}
+
+}
+
+std::atomic<bool> CapricaMemoryReport::isEnabled { false };
+
+CapricaMemoryReport::PhaseScope::PhaseScope(Phase phase) : previous(currentPhase) {
+  currentPhase = phase;
+}
+
+CapricaMemoryReport::PhaseScope::~PhaseScope() {
+  currentPhase = previous;
+}
+
+void CapricaMemoryReport::startup() {
+  isEnabled.store(conf::Performance::memoryReport, std::memory_order_relaxed);
+}
+
+void CapricaMemoryReport::allocated(MemoryOwner owner, size_t bytes) {
+  auto total = totalBytes.fetch_add(bytes, std::memory_order_relaxed) + bytes;
+  auto ownerTotal = ownerBytes[(size_t)owner].fetch_add(bytes, std::memory_order_relaxed) + bytes;
+  updateMax(totalHighWater, total);
+  updateMax(ownerHighWater[(size_t)owner], ownerTotal);
+  updateMax(phaseHighWater[(size_t)currentPhase], total);
+}
+
+void CapricaMemoryReport::freed(MemoryOwner owner, size_t bytes) {
+  totalBytes.fetch_sub(bytes, std::memory_order_relaxed);
+  ownerBytes[(size_t)owner].fetch_sub(bytes, std::memory_order_relaxed);
+}
+
+void CapricaMemoryReport::recordScript(const std::string& name,
+                                       size_t astBytes,
+                                       size_t pexBytes,
+                                       size_t outputBytes) {
+  std::scoped_lock lock { scriptsMutex };
+  scripts.push_back(ScriptRecord { name, astBytes, pexBytes, outputBytes });
+}
+
+void CapricaMemoryReport::output() {
+  if (!enabled())
+    return;
+
+  PROCESS_MEMORY_COUNTERS counters {};
+  if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+    std::printf("Peak RSS: %.1f MB\n", toMB(counters.PeakWorkingSetSize));
+  std::printf("Allocator memory high-water mark: %.1f MB\n", toMB(totalHighWater.load()));
+
+  std::printf("By owner (in use at exit / high-water mark):\n");
+  for (size_t i = 0; i < OwnerCount; i++) {
+    if (!ownerHighWater[i].load())
+      continue;
+    std::printf("  %-20s %10.1f MB %10.1f MB\n",
+                ownerNames[i],
+                toMB(ownerBytes[i].load()),
+                toMB(ownerHighWater[i].load()));
+  }
+
+  std::printf("By phase (high-water mark of all allocator memory reached while allocating in the phase):\n");
+  for (size_t i = 0; i < PhaseCount; i++) {
+    if (!phaseHighWater[i].load())
+      continue;
+    std::printf("  %-20s %10.1f MB\n", phaseNames[i], toMB(phaseHighWater[i].load()));
+  }
+
+  std::scoped_lock lock { scriptsMutex };
+  if (scripts.empty())
+    return;
+  auto count = std::min(scripts.size(), LargestScriptCount);
+  std::partial_sort(scripts.begin(), scripts.begin() + count, scripts.end(), [](auto& a, auto& b) {
+    return a.astBytes > b.astBytes;
+  });
+  std::printf("Largest scripts by AST memory:\n");
+  for (size_t i = 0; i < count; i++) {
+    auto& s = scripts[i];
+    std::printf("  %s: AST %zu KB, PexFile %zu KB, output %zu KB\n",
+                s.name.c_str(),
+                s.astBytes / 1024,
+                s.pexBytes / 1024,
+                s.outputBytes / 1024);
+  }
+}
+
+}
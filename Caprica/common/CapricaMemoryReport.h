@@ -0,0 +1,66 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+namespace caprica {
+
+// What a tracked allocation is being used for.
+enum class MemoryOwner : uint8_t {
+  Unknown,
+  ReadBuffers,
+  ScriptAst,
+  PexFile,
+  PexWriter,
+  StringPool,
+
+  Count,
+};
+
+// Tracks the memory held by the compiler's allocators, tagged by owner,
+// for --memory-report. When the report isn't enabled the only cost is
+// checking a flag when an allocator is created.
+struct CapricaMemoryReport final {
+  enum class Phase : uint8_t {
+    Other,
+    Read,
+    Parse,
+    Semantic,
+    Compile,
+    Write,
+
+    Count,
+  };
+
+  // Attributes the allocations made on this thread to a phase
+  // of the compile until it goes out of scope.
+  struct PhaseScope final {
+    explicit PhaseScope(Phase phase);
+    PhaseScope(const PhaseScope&) = delete;
+    PhaseScope& operator=(const PhaseScope&) = delete;
+    ~PhaseScope();
+
+  private:
+    Phase previous;
+  };
+
+  static bool enabled() { return isEnabled.load(std::memory_order_relaxed); }
+  static void startup();
+
+  // Allocators check enabled() when they start tracking their memory, and
+  // from then on report everything they get and give back, so that memory
+  // acquired before the report was enabled is never counted as freed.
+  static void allocated(MemoryOwner owner, size_t bytes);
+  static void freed(MemoryOwner owner, size_t bytes);
+  // Records how much memory compiling a script needed,
+  // for the list of the largest scripts.
+  static void recordScript(const std::string& name, size_t astBytes, size_t pexBytes, size_t outputBytes);
+
+  static void output();
+
+private:
+  static std::atomic<bool> isEnabled;
+};
+
+}
@@ -1,11 +1,15 @@
 #pragma once
 
+#include <atomic>
+
 namespace caprica {
 
 struct CapricaReferenceState final {
   bool isInitialized { false };
-  bool isRead { false };
-  bool isWritten { false };
+  // These are set by the function bodies that use the variable,
+  // which may be checked on different threads.
+  std::atomic<bool> isRead { false };
+  std::atomic<bool> isWritten { false };
 };
 
 }
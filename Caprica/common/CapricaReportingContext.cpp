@@ -2,21 +2,200 @@
 
 #include <algorithm>
 #include <cassert>
+#include <cstdio>
+#include <cstring>
 #include <iostream>
+#include <iterator>
+#include <map>
+#include <mutex>
 
 #include <common/CapricaConfig.h>
+#include <common/CapricaStructuredDiagnostics.h>
 
 #include <Windows.h>
 
 namespace caprica {
 
+static std::mutex errorStreamMutex {};
+std::map<size_t, CapricaReportingContext::SubmittedDiagnostics> CapricaReportingContext::submittedDiagnostics {};
+// Guarded by errorStreamMutex.
+static size_t nextReportOrder { 0 };
+
 void CapricaReportingContext::pushToErrorStream(std::string&& msg, bool isError) {
   if (!conf::Performance::performanceTestMode || isError) {
+    std::lock_guard<std::mutex> lk { errorStreamMutex };
     std::cout.flush();
     std::cerr << msg << std::endl;
   }
 }
 
+void CapricaReportingContext::submitDiagnostics() {
+  if (reportOrder == NoReportOrder) {
+    flushDiagnostics();
+    return;
+  }
+
+  // The diagnostics are only formatted by whoever writes them out, which is
+  // whoever submits the diagnostics that are next in report order.
+  SubmittedDiagnostics submitted {};
+  submitted.context = this;
+  submitted.diagnostics = std::move(pendingDiagnostics);
+  pendingDiagnostics.clear();
+
+  std::lock_guard<std::mutex> lk { errorStreamMutex };
+  submittedDiagnostics.emplace(reportOrder, std::move(submitted));
+  reportOrder = NoReportOrder;
+  auto f = submittedDiagnostics.begin();
+  if (f == submittedDiagnostics.end() || f->first != nextReportOrder)
+    return;
+  std::cout.flush();
+  while (f != submittedDiagnostics.end() && f->first == nextReportOrder) {
+    std::string text;
+    std::vector<CapricaStructuredDiagnostics::Record> records;
+    f->second.context->formatDiagnostics(f->second.diagnostics, text, records);
+    std::cerr << text;
+    CapricaStructuredDiagnostics::add(std::move(records));
+    nextReportOrder++;
+    f = submittedDiagnostics.erase(f);
+  }
+  std::cerr.flush();
+}
+
+void CapricaReportingContext::flushDiagnostics() {
+  if (pendingDiagnostics.empty())
+    return;
+
+  std::string text;
+  std::vector<CapricaStructuredDiagnostics::Record> records;
+  formatDiagnostics(pendingDiagnostics, text, records);
+  pendingDiagnostics.clear();
+
+  std::lock_guard<std::mutex> lk { errorStreamMutex };
+  std::cout.flush();
+  std::cerr << text;
+  std::cerr.flush();
+  CapricaStructuredDiagnostics::add(std::move(records));
+}
+
+void CapricaReportingContext::flushSubmittedDiagnostics() {
+  std::lock_guard<std::mutex> lk { errorStreamMutex };
+  if (submittedDiagnostics.empty())
+    return;
+  std::cout.flush();
+  for (auto& d : submittedDiagnostics) {
+    std::string text;
+    std::vector<CapricaStructuredDiagnostics::Record> records;
+    d.second.context->formatDiagnostics(d.second.diagnostics, text, records);
+    std::cerr << text;
+    CapricaStructuredDiagnostics::add(std::move(records));
+  }
+  std::cerr.flush();
+  nextReportOrder = submittedDiagnostics.rbegin()->first + 1;
+  submittedDiagnostics.clear();
+}
+
+void CapricaReportingContext::writeStructuredDiagnostics() {
+  CapricaStructuredDiagnostics::write();
+}
+
+void CapricaReportingContext::formatDiagnostics(const std::vector<PendingDiagnostic>& diagnostics,
+                                                std::string& text,
+                                                std::vector<CapricaStructuredDiagnostics::Record>& records) {
+  const bool wantRecords = CapricaStructuredDiagnostics::enabled();
+  for (auto& diag : diagnostics) {
+    auto message = formatMessage(diag);
+    text += formatDiagnostic(diag, message);
+    text += '\n';
+    if (wantRecords) {
+      CapricaStructuredDiagnostics::Record rec {};
+      rec.file = filename;
+      rec.baseDirectory = baseDirectory;
+      if (diag.hasLocation)
+        getLineAndColumn(diag.location, &rec.line, &rec.column);
+      rec.warningNumber = diag.warningNumber;
+      rec.isError = diag.isError;
+      rec.message = std::move(message);
+      records.emplace_back(std::move(rec));
+    }
+  }
+}
+
+std::string CapricaReportingContext::formatMessage(const PendingDiagnostic& diag) {
+  // Each conversion is formatted on its own, with the argument's type as it was kept.
+  std::string message;
+  size_t nextArg = 0;
+  for (auto c = diag.format; *c != '\0'; c++) {
+    if (*c != '%') {
+      message += *c;
+      continue;
+    }
+    if (c[1] == '%') {
+      message += '%';
+      c++;
+      continue;
+    }
+    // The flags, width and precision are kept, but the length
+    // is replaced with the one for the type the argument was kept as.
+    std::string spec = "%";
+    auto e = c + 1;
+    while (*e != '\0' && strchr("-+ #0123456789.", *e))
+      spec += *e++;
+    while (*e != '\0' && strchr("hljztL", *e))
+      e++;
+    if (*e == '\0') {
+      message.append(c, e);
+      break;
+    }
+    if (nextArg >= diag.args.size()) {
+      message.append(c, e + 1);
+      c = e;
+      continue;
+    }
+    auto& arg = diag.args[nextArg++];
+    auto conversion = *e;
+    char buf[128];
+    switch (conversion) {
+      case 's':
+        spec += 's';
+        if (arg.kind == DiagnosticArg::Kind::String)
+          message += spec == "%s" ? arg.s : formatString(spec.c_str(), arg.s.c_str());
+        break;
+      case 'c':
+        spec += 'c';
+        snprintf(buf, sizeof(buf), spec.c_str(), (int)arg.i);
+        message += buf;
+        break;
+      case 'f':
+      case 'F':
+      case 'e':
+      case 'E':
+      case 'g':
+      case 'G':
+      case 'a':
+      case 'A':
+        spec += conversion;
+        snprintf(buf, sizeof(buf), spec.c_str(), arg.kind == DiagnosticArg::Kind::Float ? arg.f : (double)arg.i);
+        message += buf;
+        break;
+      case 'd':
+      case 'i':
+        spec += "ll";
+        spec += conversion;
+        snprintf(buf, sizeof(buf), spec.c_str(), arg.i);
+        message += buf;
+        break;
+      default:
+        spec += "ll";
+        spec += conversion;
+        snprintf(buf, sizeof(buf), spec.c_str(), arg.u);
+        message += buf;
+        break;
+    }
+    c = e;
+  }
+  return message;
+}
+
 void CapricaReportingContext::breakIfDebugging() {
   if (IsDebuggerPresent())
     __debugbreak();
@@ -24,12 +203,28 @@ void CapricaReportingContext::breakIfDebugging() {
 
 void CapricaReportingContext::exitIfErrors() {
   if (errorCount > 0) {
+    flushSubmittedDiagnostics();
+    flushDiagnostics();
+    writeStructuredDiagnostics();
     pushToErrorStream("Compilation of '" + filename + "' failed; " + std::to_string(warningCount) + " warnings and " +
                       std::to_string(errorCount) + " errors were encountered.");
     throw std::runtime_error("");
   }
 }
 
+void CapricaReportingContext::takeDiagnostics(CapricaReportingContext& child) {
+  warningCount += child.warningCount;
+  errorCount += child.errorCount;
+  child.warningCount = 0;
+  child.errorCount = 0;
+  pendingDiagnostics.insert(pendingDiagnostics.end(),
+                            std::make_move_iterator(child.pendingDiagnostics.begin()),
+                            std::make_move_iterator(child.pendingDiagnostics.end()));
+  child.pendingDiagnostics.clear();
+  if (reportOrder == NoReportOrder)
+    flushDiagnostics();
+}
+
 bool CapricaReportingContext::isWarningError(CapricaFileLocation /* location */, size_t warningNumber) const {
   // TODO: Support disabling warnings for specific sections of code.
   if (warningNumber >= 2000 && warningNumber <= 2200)
@@ -51,8 +246,10 @@ bool CapricaReportingContext::isWarningEnabled(CapricaFileLocation /* location *
 }
 
 size_t CapricaReportingContext::getLocationLine(CapricaFileLocation location, size_t lastLineHint) {
+  if (parentContext)
+    return parentContext->getLocationLine(location, lastLineHint);
   if (!lineOffsets.size())
-    CapricaReportingContext::logicalFatal("Unable to locate line at offset %zu.", location.fileOffset);
+    CapricaReportingContext::logicalFatal("Unable to locate line at offset %u.", location.fileOffset);
   if (lastLineHint != 0) {
     if (location.fileOffset >= lineOffsets.at(lastLineHint - 1))
       return lastLineHint + 1;
@@ -72,36 +269,67 @@ size_t CapricaReportingContext::getLocationLine(CapricaFileLocation location, si
   return std::distance(lineOffsets.begin(), a);
 }
 
+std::string CapricaReportingContext::formatDiagnostic(const PendingDiagnostic& diag, const std::string& message) {
+  if (diag.warningNumber != 0) {
+    return (diag.hasLocation ? formatLocation(diag.location) : filename) +
+           (diag.isError ? ": Error W" : ": Warning W") + std::to_string(diag.warningNumber) + ": " + message;
+  }
+  if (diag.hasLocation)
+    return formatLocation(diag.location) + ": " + diag.msgType + ": " + message;
+  return filename + ": " + diag.msgType + ": " + message;
+}
+
+void CapricaReportingContext::getLineAndColumn(CapricaFileLocation loc, size_t* line, size_t* column) {
+  if (parentContext)
+    return parentContext->getLineAndColumn(loc, line, column);
+  *line = getLocationLine(loc);
+  *column = loc.fileOffset - lineOffsets.at(*line - 1) + 1;
+}
+
 std::string CapricaReportingContext::formatLocation(CapricaFileLocation loc) {
-  std::string ret = filename + " (";
-  auto line = getLocationLine(loc);
-  ret += std::to_string(line) + ", ";
-  ret += std::to_string(loc.fileOffset - lineOffsets.at(line - 1) + 1) + ")";
-  return ret;
-}
-
-void CapricaReportingContext::maybePushMessage(CapricaReportingContext* ctx,
-                                               CapricaFileLocation* location,
-                                               const char* msgType,
-                                               size_t warningNumber,
-                                               const std::string& msg,
-                                               bool forceAsError) {
+  size_t line, column;
+  getLineAndColumn(loc, &line, &column);
+  return filename + " (" + std::to_string(line) + ", " + std::to_string(column) + ")";
+}
+
+void CapricaReportingContext::pushUnlocatedMessage(const char* msgType, const std::string& msg, bool isError) {
+  pushToErrorStream(std::string(msgType) + ": " + msg, isError);
+  if (CapricaStructuredDiagnostics::enabled()) {
+    std::vector<CapricaStructuredDiagnostics::Record> records(1);
+    records[0].isError = isError;
+    records[0].message = msg;
+    CapricaStructuredDiagnostics::add(std::move(records));
+  }
+}
+
+bool CapricaReportingContext::prepareDiagnostic(PendingDiagnostic& diag,
+                                                CapricaFileLocation* location,
+                                                const char* msgType,
+                                                size_t warningNumber,
+                                                bool forceAsError) {
+  diag.msgType = msgType;
+  diag.isError = forceAsError;
+  if (location != nullptr) {
+    diag.hasLocation = true;
+    diag.location = *location;
+  }
   if (warningNumber != 0) {
-    if (ctx->isWarningEnabled(*location, warningNumber)) {
-      if (ctx->isWarningError(*location, warningNumber)) {
-        ctx->errorCount++;
-        pushToErrorStream(ctx->formatLocation(*location) + ": Error W" + std::to_string(warningNumber) + ": " + msg,
-                          true);
-      } else {
-        ctx->warningCount++;
-        pushToErrorStream(ctx->formatLocation(*location) + ": Warning W" + std::to_string(warningNumber) + ": " + msg);
-      }
-    }
-  } else if (location != nullptr) {
-    pushToErrorStream(ctx->formatLocation(*location) + ": " + msgType + ": " + msg, forceAsError);
-  } else {
-    pushToErrorStream(std::string(msgType) + ": " + msg, forceAsError);
+    if (!isWarningEnabled(diag.location, warningNumber))
+      return false;
+    diag.warningNumber = warningNumber;
+    diag.isError = isWarningError(diag.location, warningNumber);
+    if (diag.isError)
+      errorCount++;
+    else
+      warningCount++;
   }
+  return !conf::Performance::performanceTestMode || diag.isError;
+}
+
+void CapricaReportingContext::queueDiagnostic(PendingDiagnostic&& diag) {
+  pendingDiagnostics.emplace_back(std::move(diag));
+  if (reportOrder == NoReportOrder)
+    flushDiagnostics();
 }
 
 }
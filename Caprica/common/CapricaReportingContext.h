@@ -2,19 +2,24 @@
 
 #include <cstdint>
 
+#include <map>
 #include <memory>
 #include <stdexcept>
 #include <string>
+#include <type_traits>
 #include <vector>
 
 #include <common/allocators/FileOffsetPool.h>
 #include <common/CapricaFileLocation.h>
+#include <common/CapricaStructuredDiagnostics.h>
 #include <common/UtilMacros.h>
 
 namespace caprica {
 
 struct CapricaReportingContext final {
   std::string filename;
+  // The directory filename is relative to, if it's relative and that's known.
+  std::string baseDirectory {};
   // TODO: fix Imports hack
   bool m_QuietWarnings { false };
   size_t warningCount { 0 };
@@ -27,7 +32,17 @@ struct CapricaReportingContext final {
   CapricaReportingContext& operator=(CapricaReportingContext&&) = delete;
 
   CapricaReportingContext(const std::string& name) : filename(name) { lineOffsets.push_back(0); }
-  ~CapricaReportingContext() = default;
+  // A context for part of parentCtx's file that's checked on another thread.
+  // It holds on to its diagnostics until the parent takes them with
+  // takeDiagnostics(), so they're reported in the same order regardless of
+  // which thread did the work.
+  explicit CapricaReportingContext(CapricaReportingContext* parentCtx)
+      : filename(parentCtx->filename),
+        baseDirectory(parentCtx->baseDirectory),
+        m_QuietWarnings(parentCtx->m_QuietWarnings),
+        parentContext(parentCtx),
+        reportOrder(0) { }
+  ~CapricaReportingContext() { flushDiagnostics(); }
 
   size_t getLocationLine(CapricaFileLocation location, size_t lastLineHint = 0);
   void pushNextLineOffset(CapricaFileLocation location) { lineOffsets.push_back(location.fileOffset); }
@@ -36,17 +51,55 @@ struct CapricaReportingContext final {
   static void breakIfDebugging();
   NEVER_INLINE
   void exitIfErrors();
+  // Adds the diagnostics of a context created for part of this
+  // one's file to this one, as if they had been reported here.
+  NEVER_INLINE
+  void takeDiagnostics(CapricaReportingContext& child);
 
+  // Once a context has been given a report order, its diagnostics are
+  // buffered rather than written as they happen. submitDiagnostics() hands
+  // them to the reporter, which writes each context's diagnostics in one
+  // piece and in report order, so output from different worker threads
+  // neither interleaves nor depends on scheduling.
+  void setReportOrder(size_t order) { reportOrder = order; }
+  NEVER_INLINE
+  void submitDiagnostics();
+  // Writes out this context's buffered diagnostics immediately.
+  NEVER_INLINE
+  void flushDiagnostics();
+  // Writes out everything submitted so far, regardless of order.
+  // This is used when compilation is about to stop.
+  NEVER_INLINE
+  static void flushSubmittedDiagnostics();
+  // Writes the structured diagnostics file, if one was requested.
+  NEVER_INLINE
+  static void writeStructuredDiagnostics();
+
+  // The messages of diagnostics are only formatted once they're written out,
+  // so msg has to be a string literal, but the arguments are copied.
   template <typename... Args>
   NEVER_INLINE void error(CapricaFileLocation location, const char* msg, Args&&... args) {
     errorCount++;
-    maybePushMessage(this, &location, "Error", 0, formatString(msg, std::forward<Args>(args)...), true);
+    pushMessage(&location, "Error", 0, true, msg, std::forward<Args>(args)...);
     breakIfDebugging();
   }
 
   template <typename... Args>
   [[noreturn]] NEVER_INLINE void fatal(CapricaFileLocation location, const char* msg, Args&&... args) {
-    maybePushMessage(this, &location, "Fatal Error", 0, formatString(msg, std::forward<Args>(args)...), true);
+    pushMessage(&location, "Fatal Error", 0, true, msg, std::forward<Args>(args)...);
+    flushSubmittedDiagnostics();
+    flushDiagnostics();
+    writeStructuredDiagnostics();
+    throw std::runtime_error("");
+  }
+
+  // For errors about the file as a whole, rather than a place in it.
+  template <typename... Args>
+  [[noreturn]] NEVER_INLINE void fatal(const char* msg, Args&&... args) {
+    pushMessage(nullptr, "Fatal Error", 0, true, msg, std::forward<Args>(args)...);
+    flushSubmittedDiagnostics();
+    flushDiagnostics();
+    writeStructuredDiagnostics();
     throw std::runtime_error("");
   }
 
@@ -55,7 +108,9 @@ struct CapricaReportingContext final {
   // file is likely not available.
   template <typename... Args>
   [[noreturn]] NEVER_INLINE static void logicalFatal(const char* msg, Args&&... args) {
-    maybePushMessage(nullptr, nullptr, "Fatal Error", 0, formatString(msg, std::forward<Args>(args)...), true);
+    flushSubmittedDiagnostics();
+    pushUnlocatedMessage("Fatal Error", formatString(msg, std::forward<Args>(args)...), true);
+    writeStructuredDiagnostics();
     throw std::runtime_error("");
   }
 
@@ -319,12 +374,70 @@ struct CapricaReportingContext final {
   DEFINE_WARNING_A1(
       7005, Skyrim_Casting_None_Call_Result, "Casting None method call result to type '%s'", const char*, type);
 
+  // Warnings 8000-9000 are about a file as a whole, rather than a place in it.
+  NEVER_INLINE void warning_W8000_Transform_Optimization_Unsupported_Game(const char* gameName) {
+    fileWarning(8000,
+                "Optimization is currently only supported for Fallout 4, not %s, so this file won't be optimized.",
+                gameName);
+  }
+
 #undef DEFINE_WARNING_A1
 #undef DEFINE_WARNING_A2
 #undef DEFINE_WARNING_A3
 
 private:
+  // An argument for a diagnostic's message, kept until it's formatted.
+  struct DiagnosticArg final {
+    enum class Kind : uint8_t {
+      Signed,
+      Unsigned,
+      Float,
+      String,
+    };
+
+    Kind kind { Kind::Signed };
+    union {
+      long long i { 0 };
+      unsigned long long u;
+      double f;
+    };
+    std::string s {};
+  };
+
+  struct PendingDiagnostic final {
+    const char* msgType { nullptr };
+    size_t warningNumber { 0 };
+    bool hasLocation { false };
+    bool isError { false };
+    CapricaFileLocation location {};
+    const char* format { nullptr };
+    std::vector<DiagnosticArg> args {};
+  };
+
+  // The diagnostics of a context, waiting for those before them to be submitted.
+  struct SubmittedDiagnostics final {
+    CapricaReportingContext* context { nullptr };
+    std::vector<PendingDiagnostic> diagnostics {};
+  };
+  // By report order. Guarded by the error stream's mutex.
+  static std::map<size_t, SubmittedDiagnostics> submittedDiagnostics;
+
   allocators::FileOffsetPool lineOffsets {};
+  // Set for the contexts of work split off from another, whose lines we use.
+  CapricaReportingContext* parentContext { nullptr };
+  static constexpr size_t NoReportOrder = (size_t)-1;
+  size_t reportOrder { NoReportOrder };
+  std::vector<PendingDiagnostic> pendingDiagnostics {};
+
+  NEVER_INLINE
+  std::string formatDiagnostic(const PendingDiagnostic& diag, const std::string& message);
+  NEVER_INLINE
+  static std::string formatMessage(const PendingDiagnostic& diag);
+  NEVER_INLINE
+  void formatDiagnostics(const std::vector<PendingDiagnostic>& diagnostics,
+                         std::string& text,
+                         std::vector<CapricaStructuredDiagnostics::Record>& records);
+  void getLineAndColumn(CapricaFileLocation loc, size_t* line, size_t* column);
 
   NEVER_INLINE
   static void pushToErrorStream(std::string&& msg, bool isError = false);
@@ -334,19 +447,73 @@ private:
   bool isWarningEnabled(CapricaFileLocation location, size_t warningNumber) const;
   NEVER_INLINE
   std::string formatLocation(CapricaFileLocation loc);
+  // For messages that don't belong to a file, which are written out immediately.
+  NEVER_INLINE
+  static void pushUnlocatedMessage(const char* msgType, const std::string& msg, bool isError);
+  // Fills in everything but the message, and returns false if the diagnostic shouldn't be reported.
+  NEVER_INLINE
+  bool prepareDiagnostic(PendingDiagnostic& diag,
+                         CapricaFileLocation* location,
+                         const char* msgType,
+                         size_t warningNumber,
+                         bool forceAsError);
   NEVER_INLINE
-  static void maybePushMessage(CapricaReportingContext* ctx,
-                               CapricaFileLocation* loc,
-                               const char* msgType,
-                               size_t warnNum,
-                               const std::string& msg,
-                               bool forceAsError = false);
+  void queueDiagnostic(PendingDiagnostic&& diag);
+
+  template <typename T>
+  static DiagnosticArg makeArg(T&& val) {
+    using U = std::decay_t<T>;
+    DiagnosticArg arg {};
+    if constexpr (std::is_floating_point_v<U>) {
+      arg.kind = DiagnosticArg::Kind::Float;
+      arg.f = (double)val;
+    } else if constexpr (std::is_enum_v<U>) {
+      return makeArg((std::underlying_type_t<U>)val);
+    } else if constexpr (std::is_integral_v<U> && std::is_signed_v<U>) {
+      arg.kind = DiagnosticArg::Kind::Signed;
+      arg.i = (long long)val;
+    } else if constexpr (std::is_integral_v<U>) {
+      arg.kind = DiagnosticArg::Kind::Unsigned;
+      arg.u = (unsigned long long)val;
+    } else {
+      static_assert(std::is_convertible_v<U, const char*>, "Unsupported diagnostic argument type!");
+      // The string may well be a temporary, so it's copied.
+      arg.kind = DiagnosticArg::Kind::String;
+      const char* str = val;
+      arg.s = str ? str : "(null)";
+    }
+    return arg;
+  }
+
+  template <typename... Args>
+  ALWAYS_INLINE void pushMessage(CapricaFileLocation* location,
+                                 const char* msgType,
+                                 size_t warningNumber,
+                                 bool forceAsError,
+                                 const char* msg,
+                                 Args&&... args) {
+    PendingDiagnostic diag {};
+    if (!prepareDiagnostic(diag, location, msgType, warningNumber, forceAsError))
+      return;
+    diag.format = msg;
+    if constexpr (sizeof...(args) != 0) {
+      diag.args.reserve(sizeof...(args));
+      (diag.args.emplace_back(makeArg(std::forward<Args>(args))), ...);
+    }
+    queueDiagnostic(std::move(diag));
+  }
 
   template <typename... Args>
   ALWAYS_INLINE void warning(CapricaFileLocation location, size_t warningNumber, const char* msg, Args&&... args) {
     // TODO: fix Imports hack
     if (!m_QuietWarnings)
-      maybePushMessage(this, &location, nullptr, warningNumber, formatString(msg, std::forward<Args>(args)...));
+      pushMessage(&location, nullptr, warningNumber, false, msg, std::forward<Args>(args)...);
+  }
+
+  template <typename... Args>
+  ALWAYS_INLINE void fileWarning(size_t warningNumber, const char* msg, Args&&... args) {
+    if (!m_QuietWarnings)
+      pushMessage(nullptr, nullptr, warningNumber, false, msg, std::forward<Args>(args)...);
   }
 };
 
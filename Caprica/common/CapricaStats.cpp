@@ -3,6 +3,9 @@
 #include <iostream>
 #include <type_traits>
 
+#include <common/allocators/HeapBlockCache.h>
+#include <common/allocators/PerThreadPool.h>
+
 namespace caprica {
 
 CapricaStats::counter_type CapricaStats::peekedTokenCount { 0 };
@@ -40,6 +43,8 @@ static typename std::enable_if_t<std::is_same<CounterType, NopType>::value> inte
 
 void CapricaStats::outputStats() {
   internalOutputStats<decltype(CapricaStats::peekedTokenCount), CapricaStats::NopIncStruct>();
+  allocators::HeapBlockCache::outputStats();
+  allocators::PerThreadPool::outputStats();
 }
 
 void CapricaStats::outputImportedCount() {
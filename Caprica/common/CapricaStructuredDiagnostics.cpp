@@ -0,0 +1,189 @@
+#include <common/CapricaStructuredDiagnostics.h>
+
+#include <algorithm>
+#include <cctype>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <iterator>
+#include <mutex>
+
+#include <common/CapricaConfig.h>
+#include <common/FSUtils.h>
+
+namespace caprica {
+
+static std::mutex recordsMutex {};
+// Guarded by recordsMutex.
+static std::vector<CapricaStructuredDiagnostics::Record> allRecords {};
+
+static void appendJsonString(std::string& out, const std::string& str) {
+  out += '"';
+  for (auto c : str) {
+    switch (c) {
+      case '"':
+        out += "\\\"";
+        break;
+      case '\\':
+        out += "\\\\";
+        break;
+      case '\n':
+        out += "\\n";
+        break;
+      case '\r':
+        out += "\\r";
+        break;
+      case '\t':
+        out += "\\t";
+        break;
+      default:
+        if ((unsigned char)c < 0x20) {
+          char buf[8];
+          snprintf(buf, sizeof(buf), "\\u%04x", (unsigned)c);
+          out += buf;
+        } else {
+          out += c;
+        }
+        break;
+    }
+  }
+  out += '"';
+}
+
+static std::string warningId(size_t warningNumber) {
+  return "W" + std::to_string(warningNumber);
+}
+
+static std::string writeJson(const std::vector<CapricaStructuredDiagnostics::Record>& records) {
+  std::string out = "{\n  \"diagnostics\": [";
+  bool first = true;
+  for (auto& r : records) {
+    out += first ? "\n    {" : ",\n    {";
+    first = false;
+    out += "\"file\": ";
+    appendJsonString(out, r.file);
+    out += ", \"line\": " + std::to_string(r.line);
+    out += ", \"column\": " + std::to_string(r.column);
+    out += r.isError ? ", \"severity\": \"error\"" : ", \"severity\": \"warning\"";
+    if (r.warningNumber != 0)
+      out += ", \"id\": \"" + warningId(r.warningNumber) + "\"";
+    out += ", \"message\": ";
+    appendJsonString(out, r.message);
+    out += "}";
+  }
+  out += "\n  ]\n}\n";
+  return out;
+}
+
+// Turns a path into a URI reference, with forward slashes, and everything
+// but unreserved characters percent-encoded. Absolute paths become file URIs.
+static std::string pathToUri(const std::string& path, bool isDirectory) {
+  std::string out;
+  if (std::filesystem::path(path).is_absolute()) {
+    // UNC paths already start with the authority's slashes.
+    out = (path.size() > 1 && path[0] == '\\' && path[1] == '\\') ? "file:" : "file:///";
+  }
+  for (auto c : path) {
+    if (c == '\\') {
+      out += '/';
+    } else if (isalnum((unsigned char)c) || (c != '\0' && strchr("-._~/:", c))) {
+      out += c;
+    } else {
+      char buf[4];
+      snprintf(buf, sizeof(buf), "%%%02X", (unsigned)(unsigned char)c);
+      out += buf;
+    }
+  }
+  if (isDirectory && (out.empty() || out.back() != '/'))
+    out += '/';
+  return out;
+}
+
+static std::string writeSarif(const std::vector<CapricaStructuredDiagnostics::Record>& records) {
+  // Relative paths are relative to the directory the file was found in, or
+  // otherwise to the working directory, each of which gets a base id.
+  std::vector<std::string> baseDirectories {};
+  const auto baseIdOf = [&baseDirectories](const CapricaStructuredDiagnostics::Record& r) {
+    auto dir = r.baseDirectory.empty() ? std::filesystem::current_path().string() : r.baseDirectory;
+    auto f = std::find(baseDirectories.begin(), baseDirectories.end(), dir);
+    if (f == baseDirectories.end())
+      f = baseDirectories.insert(baseDirectories.end(), std::move(dir));
+    return "SRCROOT" + std::to_string(std::distance(baseDirectories.begin(), f));
+  };
+
+  std::string results;
+  bool first = true;
+  for (auto& r : records) {
+    results += first ? "\n      {" : ",\n      {";
+    first = false;
+    if (r.warningNumber != 0)
+      results += "\"ruleId\": \"" + warningId(r.warningNumber) + "\", ";
+    results += r.isError ? "\"level\": \"error\", " : "\"level\": \"warning\", ";
+    results += "\"message\": {\"text\": ";
+    appendJsonString(results, r.message);
+    results += "}";
+    if (!r.file.empty()) {
+      results += ", \"locations\": [{\"physicalLocation\": {\"artifactLocation\": {\"uri\": ";
+      // The fake scripts already have URIs.
+      if (r.file.find("://") != std::string::npos) {
+        appendJsonString(results, r.file);
+      } else {
+        appendJsonString(results, pathToUri(r.file, false));
+        if (!std::filesystem::path(r.file).is_absolute()) {
+          results += ", \"uriBaseId\": ";
+          appendJsonString(results, baseIdOf(r));
+        }
+      }
+      results += "}";
+      if (r.line != 0) {
+        results += ", \"region\": {\"startLine\": " + std::to_string(r.line) +
+                   ", \"startColumn\": " + std::to_string(r.column) + "}";
+      }
+      results += "}}]";
+    }
+    results += "}";
+  }
+
+  std::string out = "{\n"
+                    "  \"$schema\": \"https://json.schemastore.org/sarif-2.1.0.json\",\n"
+                    "  \"version\": \"2.1.0\",\n"
+                    "  \"runs\": [{\n"
+                    "    \"tool\": {\"driver\": {\"name\": \"Caprica\"}},\n";
+  if (!baseDirectories.empty()) {
+    out += "    \"originalUriBaseIds\": {";
+    for (size_t i = 0; i < baseDirectories.size(); i++) {
+      out += i == 0 ? "\n      " : ",\n      ";
+      appendJsonString(out, "SRCROOT" + std::to_string(i));
+      out += ": {\"uri\": ";
+      appendJsonString(out, pathToUri(baseDirectories[i], true));
+      out += "}";
+    }
+    out += "\n    },\n";
+  }
+  out += "    \"results\": [" + results + "\n    ]\n  }]\n}\n";
+  return out;
+}
+
+bool CapricaStructuredDiagnostics::enabled() {
+  return conf::General::diagnosticsFormat != conf::General::DiagnosticsFormat::Text;
+}
+
+void CapricaStructuredDiagnostics::add(std::vector<Record>&& records) {
+  if (records.empty())
+    return;
+  std::lock_guard<std::mutex> lk { recordsMutex };
+  allRecords.insert(allRecords.end(),
+                    std::make_move_iterator(records.begin()),
+                    std::make_move_iterator(records.end()));
+}
+
+void CapricaStructuredDiagnostics::write() {
+  if (!enabled())
+    return;
+  std::lock_guard<std::mutex> lk { recordsMutex };
+  auto out = conf::General::diagnosticsFormat == conf::General::DiagnosticsFormat::Sarif ? writeSarif(allRecords)
+                                                                                          : writeJson(allRecords);
+  FSUtils::writeFileAtomically(conf::General::diagnosticsOutputFile, out.data(), out.size());
+}
+
+}
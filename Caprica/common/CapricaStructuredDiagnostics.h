@@ -0,0 +1,31 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+namespace caprica {
+
+// Collects errors and warnings as they are reported, and writes them to
+// conf::General::diagnosticsOutputFile as JSON or SARIF, so that tools
+// don't have to parse the console output.
+struct CapricaStructuredDiagnostics final {
+  struct Record final {
+    std::string file {};
+    // The directory file is relative to, if it's relative and that's known.
+    std::string baseDirectory {};
+    // 0 if the diagnostic has no location.
+    size_t line { 0 };
+    size_t column { 0 };
+    // 0 if the diagnostic isn't a numbered warning.
+    size_t warningNumber { 0 };
+    bool isError { false };
+    std::string message {};
+  };
+
+  static bool enabled();
+  // Records are kept in the order they are added.
+  static void add(std::vector<Record>&& records);
+  static void write();
+};
+
+}
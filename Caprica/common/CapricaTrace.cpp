@@ -0,0 +1,196 @@
+#include <common/CapricaTrace.h>
+
+#include <cstdio>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include <common/CapricaConfig.h>
+#include <common/FSUtils.h>
+
+namespace caprica {
+
+namespace {
+
+constexpr size_t CategoryCount = 3;
+constexpr const char* categoryNames[CategoryCount] = { "job", "blocked", "idle" };
+
+struct TraceEvent final {
+  CapricaTrace::Category category;
+  const char* name;
+  std::string_view detail;
+  std::chrono::steady_clock::time_point start;
+  std::chrono::steady_clock::duration duration;
+};
+
+struct ThreadState final {
+  size_t id { 0 };
+  const char* name { nullptr };
+  CapricaTrace::Scope* currentScope { nullptr };
+  std::atomic<uint64_t> jobsRun { 0 };
+  // Exclusive time, in nanoseconds, spent in each category.
+  std::atomic<uint64_t> categoryTime[CategoryCount] {};
+
+  // Only pushed to by the owning thread, but read by whoever writes the trace.
+  std::mutex eventsMutex {};
+  std::vector<TraceEvent> events {};
+};
+
+const auto traceEpoch = std::chrono::steady_clock::now();
+
+std::mutex threadsMutex {};
+// Guarded by threadsMutex. Never freed, as the workers are detached
+// and may outlive any point we could free them at.
+std::vector<std::unique_ptr<ThreadState>> allThreads {};
+
+thread_local ThreadState* currentThread { nullptr };
+
+ThreadState& threadState() {
+  if (!currentThread) {
+    auto st = std::make_unique<ThreadState>();
+    std::scoped_lock lock { threadsMutex };
+    st->id = allThreads.size() + 1;
+    currentThread = st.get();
+    allThreads.push_back(std::move(st));
+  }
+  return *currentThread;
+}
+
+void appendJsonString(std::string& out, std::string_view str) {
+  out += '"';
+  for (auto c : str) {
+    if (c == '"' || c == '\\') {
+      out += '\\';
+      out += c;
+    } else if ((unsigned char)c < 0x20) {
+      char buf[8];
+      snprintf(buf, sizeof(buf), "\\u%04x", (unsigned)c);
+      out += buf;
+    } else {
+      out += c;
+    }
+  }
+  out += '"';
+}
+
+void appendMicroseconds(std::string& out, std::chrono::steady_clock::duration d) {
+  char buf[32];
+  snprintf(buf, sizeof(buf), "%.3f", std::chrono::duration<double, std::micro>(d).count());
+  out += buf;
+}
+
+std::string threadName(const ThreadState& st) {
+  if (st.name)
+    return st.name;
+  return "Worker " + std::to_string(st.id);
+}
+
+}
+
+std::atomic<bool> CapricaTrace::recordEvents { false };
+
+CapricaTrace::Scope::Scope(Category cat, const char* nm, std::string_view det)
+    : category(cat), name(nm), detail(det), start(std::chrono::steady_clock::now()) {
+  auto& st = threadState();
+  parent = st.currentScope;
+  st.currentScope = this;
+  if (category == Category::Job)
+    st.jobsRun.fetch_add(1, std::memory_order_relaxed);
+}
+
+CapricaTrace::Scope::~Scope() {
+  auto duration = std::chrono::steady_clock::now() - start;
+  auto& st = threadState();
+  st.currentScope = parent;
+  if (parent)
+    parent->childTime += duration;
+  auto exclusive = std::chrono::duration_cast<std::chrono::nanoseconds>(duration - childTime).count();
+  st.categoryTime[(size_t)category].fetch_add((uint64_t)exclusive, std::memory_order_relaxed);
+
+  if (eventsEnabled()) {
+    std::scoped_lock lock { st.eventsMutex };
+    st.events.push_back(TraceEvent { category, name, detail, start, duration });
+  }
+}
+
+void CapricaTrace::startup() {
+  recordEvents.store(!conf::Performance::traceOutputFile.empty(), std::memory_order_relaxed);
+}
+
+void CapricaTrace::setThreadName(const char* name) {
+  threadState().name = name;
+}
+
+void CapricaTrace::outputThreadSummary() {
+  std::scoped_lock lock { threadsMutex };
+  for (auto& st : allThreads) {
+    const auto ms = [&](Category c) {
+      return st->categoryTime[(size_t)c].load(std::memory_order_relaxed) / 1000000;
+    };
+    std::cout << threadName(*st) << ": " << st->jobsRun.load(std::memory_order_relaxed) << " jobs, "
+              << ms(Category::Job) << "ms busy, " << ms(Category::Blocked) << "ms blocked, " << ms(Category::Idle)
+              << "ms idle" << std::endl;
+  }
+}
+
+void CapricaTrace::write() {
+  if (!eventsEnabled())
+    return;
+
+  std::string out = "{\"displayTimeUnit\": \"ms\", \"traceEvents\": [\n";
+  bool first = true;
+  const auto beginEvent = [&] {
+    out += first ? "  {" : ",\n  {";
+    first = false;
+  };
+
+  std::scoped_lock lock { threadsMutex };
+  for (auto& st : allThreads) {
+    auto tid = std::to_string(st->id);
+    beginEvent();
+    out += "\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": 1, \"tid\": " + tid + ", \"args\": {\"name\": ";
+    appendJsonString(out, threadName(*st));
+    out += "}}";
+
+    std::scoped_lock eventsLock { st->eventsMutex };
+    for (auto& e : st->events) {
+      beginEvent();
+      out += "\"name\": ";
+      appendJsonString(out, e.name);
+      out += ", \"cat\": \"";
+      out += categoryNames[(size_t)e.category];
+      out += "\", \"ph\": \"X\", \"pid\": 1, \"tid\": " + tid + ", \"ts\": ";
+      appendMicroseconds(out, e.start - traceEpoch);
+      out += ", \"dur\": ";
+      appendMicroseconds(out, e.duration);
+      if (!e.detail.empty()) {
+        out += ", \"args\": {\"file\": ";
+        appendJsonString(out, e.detail);
+        out += "}";
+      }
+      out += "}";
+    }
+  }
+  out += "\n],\n\"capricaThreads\": [";
+
+  first = true;
+  for (auto& st : allThreads) {
+    beginEvent();
+    out += "\"name\": ";
+    appendJsonString(out, threadName(*st));
+    out += ", \"jobs\": " + std::to_string(st->jobsRun.load(std::memory_order_relaxed));
+    for (size_t i = 0; i < CategoryCount; i++) {
+      out += ", \"";
+      out += categoryNames[i];
+      out += "Us\": " + std::to_string(st->categoryTime[i].load(std::memory_order_relaxed) / 1000);
+    }
+    out += "}";
+  }
+  out += "\n]}\n";
+
+  FSUtils::writeFileAtomically(conf::Performance::traceOutputFile, out.data(), out.size());
+}
+
+}
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string_view>
+
+namespace caprica {
+
+// Low-overhead instrumentation of the compile pipeline. Per-thread counters
+// are always collected; individual events are only recorded when
+// conf::Performance::traceOutputFile is set, and are written out in the
+// Chrome trace event format so they can be loaded into Perfetto.
+struct CapricaTrace final {
+  enum class Category : uint8_t {
+    // Running a job.
+    Job,
+    // Waiting on a job that is being run by another thread.
+    Blocked,
+    // A worker waiting for the queue to have something in it.
+    Idle,
+  };
+
+  struct Scope final {
+    // The strings passed in must outlive the trace.
+    Scope(Category category, const char* name, std::string_view detail = {});
+    Scope(const Scope&) = delete;
+    Scope& operator=(const Scope&) = delete;
+    ~Scope();
+
+  private:
+    Category category;
+    const char* name;
+    std::string_view detail;
+    std::chrono::steady_clock::time_point start;
+    // Used to attribute time only to the innermost scope, so that
+    // a job that blocks doesn't count the blocked time as busy.
+    Scope* parent;
+    std::chrono::steady_clock::duration childTime { 0 };
+  };
+
+  static bool eventsEnabled() { return recordEvents.load(std::memory_order_relaxed); }
+  static void startup();
+  // Names the current thread in the trace. Threads that never
+  // call this are named "Worker N".
+  static void setThreadName(const char* name);
+
+  static void outputThreadSummary();
+  static void write();
+
+private:
+  static std::atomic<bool> recordEvents;
+};
+
+}
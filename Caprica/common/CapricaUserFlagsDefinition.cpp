@@ -25,16 +25,19 @@ void CapricaUserFlagsDefinition::registerUserFlag(CapricaReportingContext& repCt
     if (f.bitIndex == flag.bitIndex && !f.flagData && !flag.flagData)
       repCtx.fatal(flag.location, "Another flag is already defined with bit index %i!", (int)flag.bitIndex);
   userFlags.push_back(flag);
-  userFlags.back().flagNum = userFlags.size() - 1;
-  flagNameMap.insert({ flag.name, userFlags.size() - 1 });
+  auto& newFlag = userFlags.back();
+  newFlag.flagNum = userFlags.size() - 1;
+  newFlag.lowerName = newFlag.name;
+  identifierToLower(newFlag.lowerName);
+  flagNameMap.insert({ identifier_ref(newFlag.name), newFlag.flagNum });
 }
 
 const CapricaUserFlagsDefinition::UserFlag& CapricaUserFlagsDefinition::findFlag(CapricaReportingContext& repCtx,
                                                                                  CapricaFileLocation loc,
-                                                                                 const std::string& name) const {
+                                                                                 identifier_ref name) const {
   auto a = flagNameMap.find(name);
   if (a == flagNameMap.end())
-    repCtx.fatal(loc, "Unknown flag '%s'!", name.c_str());
+    repCtx.fatal(loc, "Unknown flag '%s'!", name.to_string().c_str());
   return userFlags[a->second];
 }
 
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <cstdint>
+#include <deque>
 #include <map>
 #include <string>
 #include <type_traits>
@@ -28,6 +29,8 @@ struct CapricaUserFlagsDefinition final {
   struct UserFlag final {
     ValidLocations validLocations { ValidLocations::None };
     std::string name { "" };
+    // The name as it's written to the user flag table of a PexFile.
+    std::string lowerName { "" };
     uint8_t bitIndex {};
     size_t flagNum {};
     size_t flagData { 0 };
@@ -42,7 +45,7 @@ struct CapricaUserFlagsDefinition final {
   };
 
   void registerUserFlag(CapricaReportingContext& repCtx, const UserFlag& flag);
-  const UserFlag& findFlag(CapricaReportingContext& repCtx, CapricaFileLocation loc, const std::string& name) const;
+  const UserFlag& findFlag(CapricaReportingContext& repCtx, CapricaFileLocation loc, identifier_ref name) const;
   // Not that flag num is NOT the flag's bit index, it is instead
   // the flag's index in the user flags vector.
   const UserFlag& getFlag(size_t flagNum) const;
@@ -52,8 +55,10 @@ struct CapricaUserFlagsDefinition final {
   ~CapricaUserFlagsDefinition() = default;
 
 private:
-  caseless_unordered_identifier_map<size_t> flagNameMap {};
-  std::vector<UserFlag> userFlags {};
+  // The keys refer to the names of the flags, which
+  // don't move as the flags are in a deque.
+  caseless_unordered_identifier_ref_map<size_t> flagNameMap {};
+  std::deque<UserFlag> userFlags {};
 };
 
 inline auto operator~(CapricaUserFlagsDefinition::ValidLocations a) {
@@ -2,11 +2,14 @@
 
 #include <fcntl.h>
 #include <io.h>
+#include <process.h>
 
 #include <cstring>
 #include <filesystem>
+#include <fstream>
 #include <future>
 #include <sstream>
+#include <thread>
 
 #include <common/CapricaConfig.h>
 #include <common/CapricaReportingContext.h>
@@ -80,4 +83,23 @@ std::string canonical(const std::string& path) {
   }
 }
 
+void writeFileAtomically(const std::string& path, const char* data, size_t size) {
+  // The temporary file is named after the process and thread writing it, so
+  // that several builds writing the same output at once don't collide.
+  auto tmpPath = path + "." + std::to_string(_getpid()) + "." +
+                 std::to_string(std::hash<std::thread::id> {}(std::this_thread::get_id())) + ".tmp";
+  try {
+    {
+      std::ofstream tmpFile { tmpPath, std::ofstream::binary };
+      tmpFile.exceptions(std::ifstream::badbit | std::ifstream::failbit);
+      tmpFile.write(data, size);
+    }
+    std::filesystem::rename(tmpPath, path);
+  } catch (...) {
+    std::error_code ec;
+    std::filesystem::remove(tmpPath, ec);
+    throw;
+  }
+}
+
 }}
@@ -14,5 +14,8 @@ std::string_view filenameAsRef(std::string_view file);
 std::string_view parentPathAsRef(std::string_view file);
 
 std::string canonical(const std::string& path);
+// Writes to a temporary file next to `path` and then renames it into place,
+// so an interrupted build never leaves a truncated file behind.
+void writeFileAtomically(const std::string& path, const char* data, size_t size);
 
 }}
@@ -1,4 +1,7 @@
 #include <common/allocators/ChainedPool.h>
+#include <common/allocators/HeapBlockCache.h>
+
+#include <algorithm>
 
 #include <common/CapricaReportingContext.h>
 #include <common/CapricaStats.h>
@@ -11,19 +14,23 @@ ChainedPool::~ChainedPool() {
     curNode->destructor((void*)((size_t)curNode + sizeof(DestructionNode)));
     curNode = curNode->next;
   }
+
+  if (reportMemory) {
+    for (auto hp = &base; hp; hp = hp->next)
+      CapricaMemoryReport::freed(owner, hp->allocedHeapSize);
+  }
 }
 
-ChainedPool::Heap::Heap(size_t heapSize) : allocedHeapSize(heapSize), freeBytes(heapSize) {
+ChainedPool::Heap::Heap(size_t heapSize, ContiguousArena* arena)
+    : allocedHeapSize(heapSize), freeBytes(heapSize), fromArena(arena != nullptr) {
   CapricaStats::allocatedHeapCount++;
-  baseAlloc = malloc(heapSize);
-  if (!baseAlloc)
-    CapricaReportingContext::logicalFatal("Failed to allocate a Heap!");
+  baseAlloc = arena ? arena->allocateBlock(heapSize) : HeapBlockCache::acquire(heapSize);
 }
 
 ChainedPool::Heap::~Heap() {
-  if (baseAlloc) {
+  if (baseAlloc && !fromArena) {
     CapricaStats::freedHeapCount++;
-    free(baseAlloc);
+    HeapBlockCache::release(baseAlloc, allocedHeapSize);
     baseAlloc = nullptr;
   }
 
@@ -34,7 +41,7 @@ ChainedPool::Heap::~Heap() {
 }
 
 bool ChainedPool::Heap::tryAlloc(size_t size, void** retBuf) {
-  if (freeBytes > size) {
+  if (freeBytes >= size) {
     *retBuf = (void*)((size_t)baseAlloc + allocedHeapSize - freeBytes);
     freeBytes -= size;
     return true;
@@ -62,7 +69,8 @@ ChainedPool::HeapIterator& ChainedPool::HeapIterator::operator++() {
 
 char* ChainedPool::allocate(size_t size) {
   totalSize += size;
-  if (size > heapSize)
+  // Something that fills a whole heap gets one of its own.
+  if (size >= nextHeapSize)
     return (char*)allocHeap(size, size);
 Again:
   void* ret = nullptr;
@@ -71,7 +79,8 @@ Again:
       current = current->next;
       goto Again;
     }
-    auto alloced = allocHeap(heapSize, size);
+    auto alloced = allocHeap(nextHeapSize, size);
+    nextHeapSize = std::max(heapSize, std::min(nextHeapSize * 2, MaxGrownHeapSize));
     if (current->next != nullptr)
       current = current->next;
     return (char*)alloced;
@@ -118,11 +127,14 @@ void ChainedPool::reset() {
     currentDestructorNode = nullptr;
   }
 
+  totalSize = 0;
   current = &base;
   auto c = current;
   auto prev = current;
   while (c && c->freeBytes != c->allocedHeapSize) {
-    if (c->allocedHeapSize != this->heapSize) {
+    if (c->oversized) {
+      if (reportMemory)
+        CapricaMemoryReport::freed(owner, c->allocedHeapSize);
       prev->next = c->next;
       c->next = nullptr;
       delete c;
@@ -137,11 +149,14 @@ void ChainedPool::reset() {
 
 void* ChainedPool::allocHeap(size_t newHeapSize, size_t firstAllocSize) {
   void* ret = nullptr;
-  auto hp = new Heap(newHeapSize);
+  auto hp = new Heap(newHeapSize, arena);
   if (!hp->tryAlloc(firstAllocSize, &ret))
     CapricaReportingContext::logicalFatal("Failed while allocating a Heap!");
+  if (reportMemory)
+    CapricaMemoryReport::allocated(owner, newHeapSize);
 
   if (newHeapSize == firstAllocSize) {
+    hp->oversized = true;
     hp->next = base.next;
     base.next = hp;
   } else {
@@ -7,12 +7,36 @@
 #include <string_view>
 #include <type_traits>
 
+#include <common/allocators/ContiguousArena.h>
+#include <common/CapricaMemoryReport.h>
 #include <common/identifier_ref.h>
 
 namespace caprica { namespace allocators {
 
 struct ChainedPool {
-  explicit ChainedPool(size_t hpSize) : heapSize(hpSize), base(hpSize) { }
+  // hpSize is the size of the first heap. The heaps after it double in size up
+  // to MaxGrownHeapSize, so that a pool that ends up holding a lot takes a few
+  // large heaps from the block cache rather than a great many small ones.
+  // If heapArena is given, every heap is taken from it rather than from the
+  // block cache, so everything allocated from this pool, and from any other
+  // pool given the same arena, is in one contiguous range of memory.
+  explicit ChainedPool(size_t hpSize,
+                       MemoryOwner memOwner = MemoryOwner::Unknown,
+                       ContiguousArena* heapArena = nullptr)
+      : heapSize(hpSize),
+        nextHeapSize(hpSize),
+        arena(heapArena),
+        base(hpSize, heapArena),
+        owner(memOwner),
+        reportMemory(CapricaMemoryReport::enabled()) {
+    if (reportMemory)
+      CapricaMemoryReport::allocated(owner, heapSize);
+  }
+  // A pool with an arena of its own, which it frees along with itself.
+  explicit ChainedPool(size_t hpSize, MemoryOwner memOwner, std::unique_ptr<ContiguousArena>&& ownArena)
+      : ChainedPool(hpSize, memOwner, ownArena.get()) {
+    ownedArena = std::move(ownArena);
+  }
   ~ChainedPool();
 
   char* allocate(size_t size);
@@ -48,8 +72,12 @@ struct ChainedPool {
 
   void reset();
   size_t totalAllocatedBytes() const { return totalSize; }
+  // The arena this pool's heaps are taken from, if any.
+  ContiguousArena* heapArena() const { return arena; }
 
 protected:
+  static constexpr size_t MaxGrownHeapSize = 1024 * 64;
+
   struct DestructionNode final {
     void (*destructor)(void*) { nullptr };
     DestructionNode* next { nullptr };
@@ -60,6 +88,10 @@ protected:
     size_t freeBytes;
     void* baseAlloc;
     Heap* next { nullptr };
+    // Holds a single allocation that was too big for a normal heap.
+    bool oversized { false };
+    // Taken from an arena, which frees it, rather than from the block cache.
+    bool fromArena;
 
     Heap() = delete;
     Heap(const Heap&) = delete;
@@ -67,7 +99,7 @@ protected:
     Heap& operator=(const Heap&) = delete;
     Heap& operator=(Heap&&) = delete;
 
-    explicit Heap(size_t heapSize);
+    explicit Heap(size_t heapSize, ContiguousArena* arena);
     ~Heap();
 
     bool tryAlloc(size_t size, void** retBuf);
@@ -85,9 +117,16 @@ protected:
   };
 
   size_t heapSize;
+  // The size of the next normal heap.
+  size_t nextHeapSize;
   size_t totalSize { 0 };
+  std::unique_ptr<ContiguousArena> ownedArena {};
+  ContiguousArena* arena;
   Heap* current { &base };
   Heap base;
+  MemoryOwner owner;
+  // Whether this pool's heaps are counted by the memory report.
+  bool reportMemory;
   DestructionNode* rootDestructorChain { nullptr };
   DestructionNode* currentDestructorNode { nullptr };
 
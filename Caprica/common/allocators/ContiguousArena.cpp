@@ -0,0 +1,37 @@
+#include <common/allocators/ContiguousArena.h>
+
+#include <common/CapricaReportingContext.h>
+
+#include <Windows.h>
+
+namespace caprica { namespace allocators {
+
+// Blocks are handed out at this alignment.
+static constexpr size_t BlockAlignment = 16;
+
+ContiguousArena::ContiguousArena() {
+  base = (char*)VirtualAlloc(nullptr, ReservedSize, MEM_RESERVE, PAGE_NOACCESS);
+  if (!base)
+    CapricaReportingContext::logicalFatal("Failed to reserve %zu bytes of address space for an arena!", ReservedSize);
+}
+
+ContiguousArena::~ContiguousArena() {
+  VirtualFree(base, 0, MEM_RELEASE);
+}
+
+void* ContiguousArena::allocateBlock(size_t size) {
+  size = (size + BlockAlignment - 1) & ~(BlockAlignment - 1);
+  auto offset = top.fetch_add(size, std::memory_order_relaxed);
+  if (offset + size > ReservedSize || offset + size < offset) {
+    CapricaReportingContext::logicalFatal("A single script needed more than the %zu bytes its syntax tree can use!",
+                                          ReservedSize);
+  }
+  // Committing a page that is already committed is fine, so
+  // blocks that share a page don't need to agree on who commits it.
+  auto block = VirtualAlloc(base + offset, size, MEM_COMMIT, PAGE_READWRITE);
+  if (!block)
+    CapricaReportingContext::logicalFatal("Failed to commit %zu bytes of an arena!", size);
+  return base + offset;
+}
+
+}}
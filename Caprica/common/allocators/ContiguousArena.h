@@ -0,0 +1,31 @@
+#pragma once
+
+#include <stdlib.h>
+
+#include <atomic>
+
+namespace caprica { namespace allocators {
+
+// A single range of address space that pool heaps are carved out of.
+// The whole range is reserved up front, and pages are only committed as
+// heaps are handed out, so an arena costs no more memory than it uses.
+// Because everything in an arena is within ReservedSize bytes of everything
+// else in it, the nodes in it can refer to each other with 32-bit offsets;
+// see ArenaPtr.h. Any number of threads may take heaps from an arena at once.
+// Nothing is freed on its own, the whole range is released with the arena.
+struct ContiguousArena final {
+  // Small enough that any two addresses in the arena are within an int32_t of each other.
+  static constexpr size_t ReservedSize = 1024 * 1024 * 512;
+
+  ContiguousArena();
+  ContiguousArena(const ContiguousArena&) = delete;
+  ~ContiguousArena();
+
+  void* allocateBlock(size_t size);
+
+private:
+  char* base;
+  std::atomic<size_t> top { 0 };
+};
+
+}}
@@ -0,0 +1,121 @@
+#include <common/allocators/HeapBlockCache.h>
+
+#include <bit>
+#include <iostream>
+
+#include <common/CapricaReportingContext.h>
+
+namespace caprica { namespace allocators {
+
+std::atomic<size_t> HeapBlockCache::bytesReserved { 0 };
+std::atomic<size_t> HeapBlockCache::bytesInUse { 0 };
+std::atomic<size_t> HeapBlockCache::bytesHighWater { 0 };
+
+// Set once this thread's cache has been destroyed, so that pools which
+// outlive it (statics, for instance) free their blocks directly.
+static thread_local bool threadCacheDestroyed { false };
+
+HeapBlockCache::~HeapBlockCache() {
+  threadCacheDestroyed = true;
+  for (size_t i = 0; i < ClassCount; i++) {
+    auto blk = magazines[i].head;
+    while (blk != nullptr) {
+      auto next = blk->next;
+      freeBlock(blk, classSize(i));
+      blk = next;
+    }
+    magazines[i].head = nullptr;
+    magazines[i].count = 0;
+  }
+}
+
+HeapBlockCache& HeapBlockCache::local() {
+  static thread_local HeapBlockCache cache {};
+  return cache;
+}
+
+size_t HeapBlockCache::sizeClassOf(size_t size) {
+  if (size <= ((size_t)1 << MinClassShift))
+    return 0;
+  // size is in (2^shift, 2^(shift + 1)], which is split into ClassesPerDoubling steps.
+  const size_t shift = std::bit_width(size - 1) - 1;
+  const size_t step = ((size_t)1 << shift) / ClassesPerDoubling;
+  return (shift - MinClassShift) * ClassesPerDoubling + (size - 1 - ((size_t)1 << shift)) / step + 1;
+}
+
+size_t HeapBlockCache::classSize(size_t cls) {
+  const size_t shift = MinClassShift + cls / ClassesPerDoubling;
+  return ((size_t)1 << shift) + (cls % ClassesPerDoubling) * (((size_t)1 << shift) / ClassesPerDoubling);
+}
+
+void* HeapBlockCache::allocBlock(size_t size) {
+  auto block = malloc(size);
+  if (!block)
+    CapricaReportingContext::logicalFatal("Failed to allocate a heap block of %zu bytes!", size);
+  auto reserved = bytesReserved.fetch_add(size, std::memory_order_relaxed) + size;
+  auto highWater = bytesHighWater.load(std::memory_order_relaxed);
+  while (reserved > highWater &&
+         !bytesHighWater.compare_exchange_weak(highWater, reserved, std::memory_order_relaxed)) {
+  }
+  return block;
+}
+
+void HeapBlockCache::freeBlock(void* block, size_t size) {
+  bytesReserved.fetch_sub(size, std::memory_order_relaxed);
+  free(block);
+}
+
+void* HeapBlockCache::acquire(size_t size) {
+  if (size > ((size_t)1 << MaxClassShift)) {
+    bytesInUse.fetch_add(size, std::memory_order_relaxed);
+    return allocBlock(size);
+  }
+
+  auto cls = sizeClassOf(size);
+  auto blockSize = classSize(cls);
+  bytesInUse.fetch_add(blockSize, std::memory_order_relaxed);
+  if (threadCacheDestroyed)
+    return allocBlock(blockSize);
+
+  auto& mag = local().magazines[cls];
+  if (mag.head != nullptr) {
+    auto blk = mag.head;
+    mag.head = blk->next;
+    mag.count--;
+    return blk;
+  }
+  return allocBlock(blockSize);
+}
+
+void HeapBlockCache::release(void* block, size_t size) {
+  if (size > ((size_t)1 << MaxClassShift)) {
+    bytesInUse.fetch_sub(size, std::memory_order_relaxed);
+    freeBlock(block, size);
+    return;
+  }
+
+  auto cls = sizeClassOf(size);
+  auto blockSize = classSize(cls);
+  bytesInUse.fetch_sub(blockSize, std::memory_order_relaxed);
+  if (threadCacheDestroyed) {
+    freeBlock(block, blockSize);
+    return;
+  }
+
+  auto& mag = local().magazines[cls];
+  if (mag.count * blockSize >= MaxCachedBytesPerClass && mag.count > 0) {
+    freeBlock(block, blockSize);
+    return;
+  }
+  auto blk = (FreeBlock*)block;
+  blk->next = mag.head;
+  mag.head = blk;
+  mag.count++;
+}
+
+void HeapBlockCache::outputStats() {
+  std::cout << "Heap blocks: " << bytesReserved.load() << " bytes reserved, " << bytesInUse.load()
+            << " bytes in use, high-water mark of " << bytesHighWater.load() << " bytes." << std::endl;
+}
+
+}}
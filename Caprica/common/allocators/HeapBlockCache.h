@@ -0,0 +1,59 @@
+#pragma once
+
+#include <stdlib.h>
+
+#include <atomic>
+
+namespace caprica { namespace allocators {
+
+// A per-thread cache of the raw blocks that back pool heaps.
+// Blocks are bucketed into size classes, so pools that are created and
+// torn down for every file end up reusing the same memory rather than
+// going back to malloc each time. There are four classes to each doubling
+// in size, so rounding a block up to its class makes it at most a quarter
+// bigger than was asked for, rather than up to twice as big.
+struct HeapBlockCache final {
+  HeapBlockCache() = default;
+  HeapBlockCache(const HeapBlockCache&) = delete;
+  ~HeapBlockCache();
+
+  static void* acquire(size_t size);
+  static void release(void* block, size_t size);
+  // Prints how much memory the pool heaps have held, for --dump-timing.
+  static void outputStats();
+
+private:
+  static constexpr size_t MinClassShift = 12;
+  static constexpr size_t MaxClassShift = 22;
+  static constexpr size_t ClassesPerDoubling = 4;
+  static constexpr size_t ClassCount = (MaxClassShift - MinClassShift) * ClassesPerDoubling + 1;
+  // The most memory a single thread will hold on to for each size class.
+  static constexpr size_t MaxCachedBytesPerClass = 1024 * 1024 * 8;
+
+  struct FreeBlock final {
+    FreeBlock* next { nullptr };
+  };
+
+  struct Magazine final {
+    FreeBlock* head { nullptr };
+    size_t count { 0 };
+  };
+
+  Magazine magazines[ClassCount] {};
+
+  // These only change when a whole heap block is handed out or given back,
+  // never for the allocations within one, so relaxed atomics are cheap enough.
+  // Bytes currently held from malloc, including blocks cached for reuse.
+  static std::atomic<size_t> bytesReserved;
+  // Bytes currently handed out to live pool heaps.
+  static std::atomic<size_t> bytesInUse;
+  static std::atomic<size_t> bytesHighWater;
+
+  static HeapBlockCache& local();
+  static size_t sizeClassOf(size_t size);
+  static size_t classSize(size_t cls);
+  static void* allocBlock(size_t size);
+  static void freeBlock(void* block, size_t size);
+};
+
+}}
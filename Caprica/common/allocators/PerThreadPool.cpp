@@ -0,0 +1,129 @@
+#include <common/allocators/PerThreadPool.h>
+#include <common/allocators/HeapBlockCache.h>
+
+#include <algorithm>
+#include <iostream>
+
+namespace caprica { namespace allocators {
+
+thread_local PerThreadPool::LastUsedMagazine PerThreadPool::lastUsed {};
+std::atomic<uint64_t> PerThreadPool::nextId { 1 };
+std::atomic<size_t> PerThreadPool::totalBytesReserved { 0 };
+std::atomic<size_t> PerThreadPool::totalBytesHighWater { 0 };
+
+namespace {
+struct LivePools final {
+  std::mutex mutex {};
+  std::vector<PerThreadPool*> pools {};
+};
+}
+
+// Constructed by the first pool, so it outlives every pool, even the global ones.
+static LivePools& livePools() {
+  static LivePools live {};
+  return live;
+}
+
+PerThreadPool::PerThreadPool(size_t chkSize, MemoryOwner memOwner)
+    : chunkSize(chkSize), owner(memOwner), id(nextId++) {
+  auto& live = livePools();
+  std::lock_guard<std::mutex> lk { live.mutex };
+  live.pools.push_back(this);
+}
+
+PerThreadPool::~PerThreadPool() {
+  {
+    auto& live = livePools();
+    std::lock_guard<std::mutex> lk { live.mutex };
+    live.pools.erase(std::find(live.pools.begin(), live.pools.end(), this));
+  }
+
+  for (auto& c : chunks)
+    HeapBlockCache::release(c.block, c.size);
+  for (auto& m : magazines)
+    delete m.second;
+  totalBytesReserved.fetch_sub(bytesReserved, std::memory_order_relaxed);
+}
+
+char* PerThreadPool::allocate(size_t size) {
+  // Nothing is ever freed from these pools, so rather than the chunks,
+  // the memory report counts the bytes that are actually handed out.
+  if (CapricaMemoryReport::enabled())
+    CapricaMemoryReport::allocated(owner, size);
+  auto& mag = localMagazine();
+  mag.bytesUsed.store(mag.bytesUsed.load(std::memory_order_relaxed) + size, std::memory_order_relaxed);
+  if ((size_t)(mag.end - mag.cur) >= size) {
+    auto ret = mag.cur;
+    mag.cur += size;
+    return ret;
+  }
+  return allocateFromNewChunk(mag, size);
+}
+
+PerThreadPool::Magazine& PerThreadPool::localMagazine() {
+  if (lastUsed.poolId == id)
+    return *lastUsed.magazine;
+
+  std::lock_guard<std::mutex> lk { mutex };
+  const auto thisThread = std::this_thread::get_id();
+  Magazine* mag = nullptr;
+  for (auto& m : magazines) {
+    if (m.first == thisThread) {
+      mag = m.second;
+      break;
+    }
+  }
+  if (!mag) {
+    mag = new Magazine();
+    magazines.emplace_back(thisThread, mag);
+  }
+  lastUsed.poolId = id;
+  lastUsed.magazine = mag;
+  return *mag;
+}
+
+char* PerThreadPool::allocateFromNewChunk(Magazine& mag, size_t size) {
+  // Something that would take up much of a chunk gets a block of its own,
+  // rather than leaving the rest of the thread's current chunk unused.
+  const bool ownBlock = size > chunkSize / 4;
+  const auto blockSize = ownBlock ? size : chunkSize;
+  auto block = (char*)HeapBlockCache::acquire(blockSize);
+  {
+    std::lock_guard<std::mutex> lk { mutex };
+    chunks.push_back(Chunk { block, blockSize });
+    bytesReserved += blockSize;
+  }
+  auto reserved = totalBytesReserved.fetch_add(blockSize, std::memory_order_relaxed) + blockSize;
+  auto highWater = totalBytesHighWater.load(std::memory_order_relaxed);
+  while (reserved > highWater &&
+         !totalBytesHighWater.compare_exchange_weak(highWater, reserved, std::memory_order_relaxed)) {
+  }
+
+  if (ownBlock)
+    return block;
+  mag.cur = block + size;
+  mag.end = block + chunkSize;
+  return block;
+}
+
+size_t PerThreadPool::bytesUsed() {
+  std::lock_guard<std::mutex> lk { mutex };
+  size_t used = 0;
+  for (auto& m : magazines)
+    used += m.second->bytesUsed.load(std::memory_order_relaxed);
+  return used;
+}
+
+void PerThreadPool::outputStats() {
+  size_t used = 0;
+  {
+    auto& live = livePools();
+    std::lock_guard<std::mutex> lk { live.mutex };
+    for (auto p : live.pools)
+      used += p->bytesUsed();
+  }
+  std::cout << "Per-thread pools: " << totalBytesReserved.load() << " bytes reserved, " << used
+            << " bytes used, high-water mark of " << totalBytesHighWater.load() << " bytes reserved." << std::endl;
+}
+
+}}
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <stdint.h>
+#include <stdlib.h>
+
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <common/CapricaMemoryReport.h>
+
+namespace caprica { namespace allocators {
+
+// A bump allocator that any number of threads can allocate from at once.
+// Each thread bumps through a chunk of its own, its magazine, so an
+// allocation never touches anything another thread writes; the pool's
+// lock is only taken when a thread needs a new chunk. Nothing is freed
+// on its own, every chunk is freed together when the pool is destroyed.
+struct PerThreadPool final {
+  explicit PerThreadPool(size_t chkSize, MemoryOwner memOwner = MemoryOwner::Unknown);
+  PerThreadPool(const PerThreadPool&) = delete;
+  ~PerThreadPool();
+
+  char* allocate(size_t size);
+
+  // Prints how much memory the pools have reserved and used, for --dump-timing.
+  static void outputStats();
+
+private:
+  struct Magazine final {
+    char* cur { nullptr };
+    char* end { nullptr };
+    // Only written by the thread the magazine belongs to, and only read by others for the stats.
+    std::atomic<size_t> bytesUsed { 0 };
+  };
+
+  struct Chunk final {
+    void* block;
+    size_t size;
+  };
+
+  // The magazine this thread used last, so a thread that keeps allocating
+  // from the same pool finds its magazine without taking the lock.
+  struct LastUsedMagazine final {
+    uint64_t poolId { 0 };
+    Magazine* magazine { nullptr };
+  };
+  static thread_local LastUsedMagazine lastUsed;
+
+  size_t chunkSize;
+  MemoryOwner owner;
+  // Unlike the pool's address, never reused, so a thread's
+  // last used magazine can't be mistaken for another pool's.
+  uint64_t id;
+  std::mutex mutex {};
+  std::vector<Chunk> chunks {};
+  std::vector<std::pair<std::thread::id, Magazine*>> magazines {};
+  size_t bytesReserved { 0 };
+
+  static std::atomic<uint64_t> nextId;
+  static std::atomic<size_t> totalBytesReserved;
+  static std::atomic<size_t> totalBytesHighWater;
+
+  Magazine& localMagazine();
+  char* allocateFromNewChunk(Magazine& mag, size_t size);
+  size_t bytesUsed();
+};
+
+}}
@@ -1,63 +1,149 @@
 #include <common/allocators/ReffyStringPool.h>
 
 #include <assert.h>
+#include <bit>
 #include <intrin.h>
 
+#include <common/CapricaReportingContext.h>
+
 namespace caprica { namespace allocators {
 
+ReffyStringPool::ReffyStringPool() {
+  controlBytes.resize(InitialSlotCount, EmptySlot);
+  slots.resize(InitialSlotCount);
+  reportTableSize();
+}
+
+ReffyStringPool::~ReffyStringPool() {
+  if (reportedTableBytes)
+    CapricaMemoryReport::freed(MemoryOwner::StringPool, reportedTableBytes);
+}
+
 size_t ReffyStringPool::lookup(const identifier_ref& str) {
   auto h = hash(str);
-  auto entry = find(str, h);
-  if (entry->generationNum == generationNumber)
-    return entry->stringIndex;
-  return push_back_with_hash(str, h, entry);
+  size_t slot;
+  if (find(str, h, &slot))
+    return slots[slot];
+  return push_back_with_hash(str, h, slot);
+}
+
+size_t ReffyStringPool::tryLookup(const identifier_ref& str) {
+  auto h = hash(str);
+  size_t slot;
+  if (find(str, h, &slot))
+    return slots[slot];
+  if (strings.size() >= MaxCapacity)
+    return NotAdded;
+  return push_back_with_hash(str, h, slot);
 }
 
 identifier_ref ReffyStringPool::byIndex(size_t v) const {
-  assert(v < count);
-  auto h = strings[v];
-  return identifier_ref((const char*)(h + 1), h->length);
+  assert(v < strings.size());
+  auto& h = strings[v];
+  return identifier_ref(h.data, h.length);
 }
 
 void ReffyStringPool::push_back(const identifier_ref& str) {
   auto h = hash(str);
-  push_back_with_hash(str, h, find(str, h));
+  size_t slot;
+  find(str, h, &slot);
+  push_back_with_hash(str, h, slot);
+}
+
+void ReffyStringPool::push_back_unowned(const identifier_ref& str) {
+  auto h = hash(str);
+  size_t slot;
+  find(str, h, &slot);
+  push_back_with_hash(str, h, slot, false);
 }
 
 void ReffyStringPool::reset() {
-  generationNumber++;
-  for (size_t i = 0; i < count; i++)
-    strings[i] = nullptr;
-  count = 0;
+  // The table keeps the size it grew to; it only needs to be
+  // as big as the largest file this pool has been used for.
+  strings.clear();
+  memset(controlBytes.data(), EmptySlot, controlBytes.size());
   alloc.reset();
 }
 
-ReffyStringPool::HashEntry* ReffyStringPool::find(const identifier_ref& str, size_t hash) {
-  HashEntry* entry = &hashtable[hash & mask];
-  while (entry->generationNum == generationNumber) {
-    if (entry->upperHash == (uint16_t)(hash >> 16) && str == byIndex(entry->stringIndex))
-      break;
-    if (++entry == &hashtable[MaxCapacity])
-      entry = &hashtable[0];
+// Returns true and the slot of the string if it is in the table,
+// otherwise returns false and the slot it should be inserted at.
+bool ReffyStringPool::find(const identifier_ref& str, uint32_t hash, size_t* slot) const {
+  const auto tag = _mm_set1_epi8((char)(hash & 0x7F));
+  const auto empty = _mm_set1_epi8((char)EmptySlot);
+  const size_t groupMask = (controlBytes.size() / GroupWidth) - 1;
+  size_t group = (hash >> 7) & groupMask;
+  // Triangular probing visits every group when the group count is a power of 2.
+  for (size_t probe = 1;; probe++) {
+    const auto base = group * GroupWidth;
+    const auto ctrl = _mm_loadu_si128((const __m128i*)(controlBytes.data() + base));
+    auto matches = (uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(ctrl, tag));
+    while (matches) {
+      auto i = base + std::countr_zero(matches);
+      auto& hdr = strings[slots[i]];
+      if (hdr.hash == hash && hdr.length == str.size() && !memcmp(hdr.data, str.data(), str.size())) {
+        *slot = i;
+        return true;
+      }
+      matches &= matches - 1;
+    }
+    auto empties = (uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(ctrl, empty));
+    if (empties) {
+      *slot = base + std::countr_zero(empties);
+      return false;
+    }
+    group = (group + probe) & groupMask;
   }
-  return entry;
 }
 
-size_t ReffyStringPool::push_back_with_hash(const identifier_ref& str, size_t hash, HashEntry* entry) {
-  auto hdr = (StringHeader*)alloc.allocate(sizeof(StringHeader) + str.size());
-  hdr->length = (uint16_t)str.size();
-  hdr->data = (const char*)(hdr + 1);
-  memcpy((void*)hdr->data, str.data(), str.size());
-  auto ret = count;
-  count++;
-  strings[ret] = hdr;
-  entry->generationNum = generationNumber;
-  entry->upperHash = (uint16_t)(hash >> 16);
-  entry->stringIndex = (uint16_t)ret;
+size_t ReffyStringPool::push_back_with_hash(const identifier_ref& str, uint32_t hash, size_t slot, bool copy) {
+  // The indices are stored as 16 bits, and that's all a .pex file has room for.
+  if (strings.size() >= MaxCapacity) {
+    CapricaReportingContext::logicalFatal("Unable to add the string '%s', the string table already has the maximum "
+                                          "of %zu strings a .pex file can hold!",
+                                          str.to_string().c_str(),
+                                          MaxCapacity);
+  }
+  // Keep the load factor at or below 7/8.
+  if ((strings.size() + 1) * 8 > controlBytes.size() * 7) {
+    grow();
+    find(str, hash, &slot);
+  }
+
+  const char* buf = str.data();
+  if (copy) {
+    auto owned = alloc.allocate(str.size());
+    memcpy(owned, str.data(), str.size());
+    buf = owned;
+  }
+  auto ret = strings.size();
+  strings.push_back(StringHeader { buf, hash, (uint16_t)str.size() });
+  controlBytes[slot] = (uint8_t)(hash & 0x7F);
+  slots[slot] = (uint16_t)ret;
   return ret;
 }
 
-size_t ReffyStringPool::hash(const identifier_ref& str) {
+void ReffyStringPool::grow() {
+  const auto newSize = controlBytes.size() * 2;
+  controlBytes.assign(newSize, EmptySlot);
+  slots.resize(newSize);
+  for (size_t i = 0; i < strings.size(); i++) {
+    size_t slot;
+    find(byIndex(i), strings[i].hash, &slot);
+    controlBytes[slot] = (uint8_t)(strings[i].hash & 0x7F);
+    slots[slot] = (uint16_t)i;
+  }
+  reportTableSize();
+}
+
+void ReffyStringPool::reportTableSize() {
+  if (!CapricaMemoryReport::enabled())
+    return;
+  auto bytes = controlBytes.capacity() * sizeof(uint8_t) + slots.capacity() * sizeof(uint16_t);
+  CapricaMemoryReport::allocated(MemoryOwner::StringPool, bytes - reportedTableBytes);
+  reportedTableBytes = bytes;
+}
+
+uint32_t ReffyStringPool::hash(const identifier_ref& str) {
   const char* cStr = str.data();
   size_t lenLeft = str.size();
   size_t iterCount = lenLeft >> 2;
@@ -74,7 +160,7 @@ size_t ReffyStringPool::hash(const identifier_ref& str) {
   } else if (lenLeft & 1) {
     val = _mm_crc32_u8(val, *(uint8_t*)(cStr + (iterCount * 4)));
   }
-  return ((size_t)val << 32) | val;
+  return val;
 }
 
 }}
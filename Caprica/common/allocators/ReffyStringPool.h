@@ -2,44 +2,63 @@
 
 #include <limits>
 #include <stdint.h>
+#include <vector>
 
 #include <common/allocators/ChainedPool.h>
 #include <common/identifier_ref.h>
 
 namespace caprica { namespace allocators {
 
+// An insert-only string interning table.
+// The hash table is laid out Swiss-table style: one control byte per slot,
+// holding either EmptySlot or the low 7 bits of the string's hash, scanned
+// 16 slots at a time with SSE2. A full compare is only done when the control
+// byte matches, and the table grows with the number of strings rather than
+// being fixed at the maximum capacity, so reset() only has to clear what
+// was actually used.
 struct ReffyStringPool final {
   static constexpr size_t MaxCapacity = std::numeric_limits<uint16_t>::max();
+  // Returned by tryLookup when the string isn't in the table and the table is full.
+  static constexpr size_t NotAdded = (size_t)-1;
 
-  ReffyStringPool() = default;
+  ReffyStringPool();
+  ReffyStringPool(const ReffyStringPool&) = delete;
+  ~ReffyStringPool();
 
   size_t lookup(const identifier_ref& str);
+  // Like lookup, but leaves reporting a full table to the caller.
+  size_t tryLookup(const identifier_ref& str);
   identifier_ref byIndex(size_t v) const;
   void push_back(const identifier_ref& str);
+  // Like push_back, but refers to the string where it is rather than
+  // copying it, so it has to stay alive until the pool is next reset.
+  void push_back_unowned(const identifier_ref& str);
   void reset();
-  size_t size() const { return count; };
+  size_t size() const { return strings.size(); };
 
 private:
   struct StringHeader final {
-    uint16_t length { 0 };
     const char* data { nullptr };
+    uint32_t hash { 0 };
+    uint16_t length { 0 };
   };
-  struct HashEntry final {
-    uint32_t generationNum { 0 };
-    uint16_t stringIndex { 0 };
-    uint16_t upperHash { 0 };
-  };
 
-  static constexpr size_t mask = MaxCapacity;
-  uint32_t generationNumber { 1 };
-  size_t count { 0 };
-  ChainedPool alloc { 1024 * 4 };
-  StringHeader* strings[MaxCapacity] {};
-  HashEntry hashtable[MaxCapacity] {};
+  static constexpr size_t GroupWidth = 16;
+  static constexpr size_t InitialSlotCount = 256;
+  static constexpr uint8_t EmptySlot = 0x80;
+
+  ChainedPool alloc { 1024 * 4, MemoryOwner::StringPool };
+  std::vector<StringHeader> strings {};
+  std::vector<uint8_t> controlBytes {};
+  std::vector<uint16_t> slots {};
+  // How much of the hash table has been reported to the memory report.
+  size_t reportedTableBytes { 0 };
 
-  HashEntry* find(const identifier_ref& str, size_t hash);
-  size_t push_back_with_hash(const identifier_ref& str, size_t hash, HashEntry* entry);
-  static size_t hash(const identifier_ref& str);
+  bool find(const identifier_ref& str, uint32_t hash, size_t* slot) const;
+  size_t push_back_with_hash(const identifier_ref& str, uint32_t hash, size_t slot, bool copy = true);
+  void grow();
+  void reportTableSize();
+  static uint32_t hash(const identifier_ref& str);
 };
 
 }}
@@ -1,15 +1,21 @@
 #include <algorithm>
 #include <chrono>
+#include <exception>
 #include <filesystem>
 #include <fstream>
 #include <ostream>
 #include <string>
 #include <string_view>
+#include <thread>
+#include <utility>
+#include <vector>
 
 #include <common/CapricaConfig.h>
 #include <common/CapricaJobManager.h>
+#include <common/CapricaMemoryReport.h>
 #include <common/CapricaReportingContext.h>
 #include <common/CapricaStats.h>
+#include <common/CapricaTrace.h>
 #include <common/FakeScripts.h>
 #include <common/FSUtils.h>
 #include <common/GameID.h>
@@ -62,11 +68,37 @@ bool addSingleFile(const std::string& f,
                    caprica::CapricaJobManager* jobManager,
                    PapyrusCompilationNode::NodeType nodeType);
 
-bool addFilesFromDirectory(const std::string& f,
-                           bool recursive,
-                           const std::string& baseOutputDir,
-                           caprica::CapricaJobManager* jobManager,
-                           PapyrusCompilationNode::NodeType nodeType) {
+static bool isImportNodeType(PapyrusCompilationNode::NodeType nodeType) {
+  return nodeType == PapyrusCompilationNode::NodeType::PapyrusImport ||
+         nodeType == PapyrusCompilationNode::NodeType::PasReflection ||
+         nodeType == PapyrusCompilationNode::NodeType::PexReflection;
+}
+
+// What was found in a directory. Directories are scanned on the workers,
+// so this is only added to the compilation context and the stats, and the
+// error is only written out, once the main thread gets to it.
+struct DirectoryScanResult final {
+  // The namespaces found, in the order they were found in.
+  std::vector<std::pair<std::string, caprica::caseless_unordered_identifier_ref_map<PapyrusCompilationNode*>>>
+      namespaces {};
+  size_t importedFileCount { 0 };
+  size_t inputFileCount { 0 };
+  std::string error {};
+
+  void countNode(PapyrusCompilationNode::NodeType nodeType) {
+    if (isImportNodeType(nodeType))
+      importedFileCount++;
+    else
+      inputFileCount++;
+  }
+};
+
+static bool scanDirectory(const std::string& f,
+                          bool recursive,
+                          const std::string& baseOutputDir,
+                          caprica::CapricaJobManager* jobManager,
+                          PapyrusCompilationNode::NodeType nodeType,
+                          DirectoryScanResult& result) {
   // Blargle flargle.... Using the raw Windows API is 5x
   // faster than boost::filesystem::recursive_directory_iterator,
   // at 40ms vs. 200ms for the boost solution, and the raw API
@@ -84,10 +116,13 @@ bool addFilesFromDirectory(const std::string& f,
     auto curSearchPattern = absBaseDir + curDir + "\\*";
     caprica::caseless_unordered_identifier_ref_map<PapyrusCompilationNode*> namespaceMap {};
     namespaceMap.reserve(8000);
+    // Compiled scripts are only imported if there isn't a source
+    // for them in the same directory, so they're added last.
+    std::vector<WIN32_FIND_DATA> pexImports {};
 
     hFind = FindFirstFileA(curSearchPattern.c_str(), &data);
     if (hFind == INVALID_HANDLE_VALUE) {
-      std::cout << "An error occured while trying to iterate the files in '" << curSearchPattern << "'!" << std::endl;
+      result.error = "An error occured while trying to iterate the files in '" + curSearchPattern + "'!";
       return false;
     }
 
@@ -106,8 +141,11 @@ bool addFilesFromDirectory(const std::string& f,
           bool skip = false;
 
           switch (nodeType) {
-            case PapyrusCompilationNode::NodeType::PapyrusCompile:
             case PapyrusCompilationNode::NodeType::PapyrusImport:
+              if (conf::Papyrus::importPexFiles && pathEq(ext, ".pex"))
+                pexImports.push_back(data);
+              [[fallthrough]];
+            case PapyrusCompilationNode::NodeType::PapyrusCompile:
               if (!pathEq(ext, ".psc"))
                 skip = true;
               break;
@@ -118,6 +156,7 @@ bool addFilesFromDirectory(const std::string& f,
               break;
             case PapyrusCompilationNode::NodeType::PexReflection:
             case PapyrusCompilationNode::NodeType::PexDissassembly:
+            case PapyrusCompilationNode::NodeType::PexTransform:
               if (!pathEq(ext, ".pex"))
                 skip = true;
               break;
@@ -127,7 +166,7 @@ bool addFilesFromDirectory(const std::string& f,
           }
           if (!skip) {
             PapyrusCompilationNode* node = getNode(nodeType, jobManager, baseOutputDir, curDir, absBaseDir, data);
-
+            result.countNode(nodeType);
             namespaceMap.emplace(caprica::identifier_ref(node->baseName), node);
           }
         }
@@ -135,18 +174,98 @@ bool addFilesFromDirectory(const std::string& f,
     } while (FindNextFileA(hFind, &data));
     FindClose(hFind);
 
+    for (auto& pexData : pexImports) {
+      if (namespaceMap.count(caprica::FSUtils::basenameAsRef(pexData.cFileName)))
+        continue;
+      PapyrusCompilationNode* node = getNode(PapyrusCompilationNode::NodeType::PexReflection,
+                                             jobManager,
+                                             baseOutputDir,
+                                             curDir,
+                                             absBaseDir,
+                                             pexData);
+      result.countNode(PapyrusCompilationNode::NodeType::PexReflection);
+      namespaceMap.emplace(caprica::identifier_ref(node->baseName), node);
+    }
+
     if (conf::Papyrus::game > GameID::Skyrim) {
       auto namespaceName = curDir;
       std::replace(namespaceName.begin(), namespaceName.end(), '\\', ':');
       namespaceName = namespaceName.substr(1);
-      caprica::papyrus::PapyrusCompilationContext::pushNamespaceFullContents(namespaceName, std::move(namespaceMap));
+      result.namespaces.emplace_back(std::move(namespaceName), std::move(namespaceMap));
     } else {
-      caprica::papyrus::PapyrusCompilationContext::pushNamespaceFullContents("", std::move(namespaceMap));
+      result.namespaces.emplace_back("", std::move(namespaceMap));
     }
   }
   return true;
 }
 
+// Scans a directory on a worker, so that several can be scanned at once, and the
+// files found can already be read while the rest of the directories are scanned.
+struct DirectoryScanJob final : public CapricaJob {
+  explicit DirectoryScanJob(const std::string& dir,
+                            bool recurse,
+                            const std::string& outputDir,
+                            CapricaJobManager* mgr,
+                            PapyrusCompilationNode::NodeType type)
+      : directory(dir), recursive(recurse), baseOutputDir(outputDir), jobManager(mgr), nodeType(type) { }
+  DirectoryScanJob(const DirectoryScanJob&) = delete;
+  ~DirectoryScanJob() = default;
+
+  // Waits for the scan to finish, and adds what it found to the compilation context.
+  bool awaitAndPush() {
+    await();
+    if (exception)
+      std::rethrow_exception(exception);
+    if (!succeeded) {
+      std::cout << result.error << std::endl;
+      return false;
+    }
+    CapricaStats::importedFileCount = CapricaStats::importedFileCount.val + result.importedFileCount;
+    CapricaStats::inputFileCount = CapricaStats::inputFileCount.val + result.inputFileCount;
+    for (auto& ns : result.namespaces)
+      caprica::papyrus::PapyrusCompilationContext::pushNamespaceFullContents(ns.first, std::move(ns.second));
+    result.namespaces.clear();
+    return true;
+  }
+
+protected:
+  virtual void run() override {
+    CapricaTrace::Scope trace { CapricaTrace::Category::Job, "Scan", directory };
+    // Exceptions can't escape a job, so they're passed on to whoever awaits it.
+    try {
+      succeeded = scanDirectory(directory, recursive, baseOutputDir, jobManager, nodeType, result);
+    } catch (...) {
+      exception = std::current_exception();
+    }
+  }
+
+private:
+  std::string directory;
+  bool recursive;
+  std::string baseOutputDir;
+  CapricaJobManager* jobManager;
+  PapyrusCompilationNode::NodeType nodeType;
+  bool succeeded { false };
+  std::exception_ptr exception {};
+  DirectoryScanResult result {};
+};
+
+DirectoryScanJob* queueDirectoryScan(const std::string& f,
+                                     bool recursive,
+                                     const std::string& baseOutputDir,
+                                     caprica::CapricaJobManager* jobManager,
+                                     PapyrusCompilationNode::NodeType nodeType) {
+  // Like the nodes, the job is never freed, as the job manager
+  // may still refer to it until it shuts down.
+  auto job = new DirectoryScanJob(f, recursive, baseOutputDir, jobManager, nodeType);
+  jobManager->queueJob(job);
+  return job;
+}
+
+bool awaitDirectoryScan(DirectoryScanJob* job) {
+  return job->awaitAndPush();
+}
+
 PapyrusCompilationNode* getNode(const PapyrusCompilationNode::NodeType& nodeType,
                                 CapricaJobManager* jobManager,
                                 const std::string& baseOutputDir,
@@ -171,13 +290,6 @@ PapyrusCompilationNode* getNode(const PapyrusCompilationNode::NodeType& nodeType
     filenameToDisplay = curDir.substr(1) + "\\" + fileName;
     outputDir = baseOutputDir + curDir;
   }
-  if (nodeType == PapyrusCompilationNode::NodeType::PapyrusImport ||
-      nodeType == PapyrusCompilationNode::NodeType::PasReflection ||
-      nodeType == PapyrusCompilationNode::NodeType::PexReflection) {
-    CapricaStats::importedFileCount++;
-  } else {
-    CapricaStats::inputFileCount++;
-  }
   auto node = new caprica::papyrus::PapyrusCompilationNode(jobManager,
                                                            nodeType,
                                                            std::move(filenameToDisplay),
@@ -229,8 +341,14 @@ bool handleImports(const std::vector<std::string>& f, caprica::CapricaJobManager
     caprica::papyrus::PapyrusCompilationContext::pushNamespaceFullContents("", std::move(tempMap));
   }
   std::cout << "Importing files..." << std::endl;
+  std::vector<DirectoryScanJob*> scanJobs {};
+  scanJobs.reserve(f.size());
   for (auto& dir : f)
-    if (!addFilesFromDirectory(dir, true, "", jobManager, PapyrusCompilationNode::NodeType::PapyrusImport))
+    scanJobs.push_back(queueDirectoryScan(dir, true, "", jobManager, PapyrusCompilationNode::NodeType::PapyrusImport));
+  // The directories are added in the order they were given in,
+  // as the first script found with a name is the one used.
+  for (auto job : scanJobs)
+    if (!awaitDirectoryScan(job))
       return false;
   CapricaStats::outputImportedCount();
   return true;
@@ -271,6 +389,10 @@ bool addSingleFile(const std::string& f,
                       filename,
                       lastModTime.time_since_epoch().count(),
                       fileSize);
+  if (isImportNodeType(nodeType))
+    CapricaStats::importedFileCount++;
+  else
+    CapricaStats::inputFileCount++;
   caprica::papyrus::PapyrusCompilationContext::pushNamespaceFullContents(
       namespaceName,
       caprica::caseless_unordered_identifier_ref_map<PapyrusCompilationNode*> {
@@ -279,11 +401,54 @@ bool addSingleFile(const std::string& f,
   return true;
 }
 
-void parseUserFlags(std::string&& flagsPath) {
-  caprica::CapricaReportingContext reportingContext { flagsPath };
-  auto parser = new caprica::parser::CapricaUserFlagsParser(reportingContext, flagsPath);
-  parser->parseUserFlags(conf::Papyrus::userFlagsDefinition);
-  delete parser;
+// The user flags aren't needed until the first script is parsed,
+// so they're parsed on a worker while the directories are scanned.
+struct UserFlagsParseJob final : public CapricaJob {
+  std::string flagsPath {};
+  std::exception_ptr exception {};
+
+protected:
+  virtual void run() override {
+    CapricaTrace::Scope trace { CapricaTrace::Category::Job, "Parse", flagsPath };
+    try {
+      caprica::CapricaReportingContext reportingContext { flagsPath };
+      auto parser = new caprica::parser::CapricaUserFlagsParser(reportingContext, flagsPath);
+      parser->parseUserFlags(conf::Papyrus::userFlagsDefinition);
+      delete parser;
+    } catch (...) {
+      exception = std::current_exception();
+    }
+  }
+};
+static UserFlagsParseJob userFlagsParseJob {};
+
+void queueUserFlagsParse(std::string&& flagsPath, caprica::CapricaJobManager* jobManager) {
+  userFlagsParseJob.flagsPath = std::move(flagsPath);
+  jobManager->queueJob(&userFlagsParseJob);
+}
+
+void awaitUserFlagsParse() {
+  if (userFlagsParseJob.flagsPath.empty())
+    return;
+  userFlagsParseJob.await();
+  if (userFlagsParseJob.exception)
+    std::rethrow_exception(userFlagsParseJob.exception);
+}
+
+void startWorkers(caprica::CapricaJobManager* jobManager) {
+  CapricaTrace::startup();
+  CapricaMemoryReport::startup();
+  CapricaTrace::setThreadName("Main");
+  if (conf::General::compileInParallel)
+    jobManager->startup((uint32_t)std::thread::hardware_concurrency());
+}
+
+void stopWorkers(caprica::CapricaJobManager* jobManager) {
+  // Runs whatever has already been queued, and waits for the workers to
+  // shut down, so that none of them refer to the job manager any more.
+  jobManager->setQueueInitialized();
+  jobManager->enjoin();
+  jobManager->awaitShutdown();
 }
 
 }
@@ -295,8 +460,6 @@ int main(int argc, char* argv[]) {
     caprica::CapricaReportingContext::breakIfDebugging();
     return -1;
   }
-  if (conf::General::compileInParallel)
-    jobManager.startup((uint32_t)std::thread::hardware_concurrency());
   auto endParse = std::chrono::high_resolution_clock::now();
   if (conf::Performance::dumpTiming) {
     std::cout << "Command Line Arg Parse: "
@@ -316,14 +479,22 @@ int main(int argc, char* argv[]) {
   try {
     auto startCompile = std::chrono::high_resolution_clock::now();
     caprica::papyrus::PapyrusCompilationContext::doCompile(&jobManager);
+    caprica::CapricaReportingContext::flushSubmittedDiagnostics();
+    caprica::CapricaReportingContext::writeStructuredDiagnostics();
     auto endCompile = std::chrono::high_resolution_clock::now();
     if (conf::Performance::dumpTiming) {
       auto compTime = std::chrono::duration_cast<std::chrono::milliseconds>(endCompile - startCompile).count();
       std::cout << "Compiled "
                 << "N/A" /*caprica::CapricaStats::inputFileCount*/ << " files in " << compTime << "ms" << std::endl;
       caprica::CapricaStats::outputStats();
+      caprica::CapricaTrace::outputThreadSummary();
     }
+    caprica::CapricaTrace::write();
+    caprica::CapricaMemoryReport::output();
   } catch (const std::runtime_error& ex) {
+    caprica::CapricaReportingContext::flushSubmittedDiagnostics();
+    caprica::CapricaReportingContext::writeStructuredDiagnostics();
+    caprica::CapricaTrace::write();
     if (ex.what() != std::string(""))
       std::cout << ex.what() << std::endl;
     caprica::CapricaReportingContext::breakIfDebugging();
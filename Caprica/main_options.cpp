@@ -4,6 +4,8 @@
 #include <common/CapricaConfig.h>
 #include <common/FSUtils.h>
 
+#include <algorithm>
+#include <cstdlib>
 #include <filesystem>
 #include <fstream>
 #include <iostream>
@@ -18,12 +20,18 @@ namespace filesystem = std::filesystem;
 namespace caprica {
 struct CapricaJobManager;
 
-bool addFilesFromDirectory(const std::string& f,
-                           bool recursive,
-                           const std::string& baseOutputDir,
-                           caprica::CapricaJobManager* jobManager,
-                           caprica::papyrus::PapyrusCompilationNode::NodeType nodeType);
-void parseUserFlags(std::string&& flagsPath);
+struct DirectoryScanJob;
+
+DirectoryScanJob* queueDirectoryScan(const std::string& f,
+                                     bool recursive,
+                                     const std::string& baseOutputDir,
+                                     caprica::CapricaJobManager* jobManager,
+                                     caprica::papyrus::PapyrusCompilationNode::NodeType nodeType);
+bool awaitDirectoryScan(DirectoryScanJob* job);
+void queueUserFlagsParse(std::string&& flagsPath, caprica::CapricaJobManager* jobManager);
+void awaitUserFlagsParse();
+void startWorkers(caprica::CapricaJobManager* jobManager);
+void stopWorkers(caprica::CapricaJobManager* jobManager);
 bool handleImports(const std::vector<std::string>& f, caprica::CapricaJobManager* jobManager);
 bool addSingleFile(const std::string& f,
                    const std::string& baseOutputDir,
@@ -42,6 +50,7 @@ static std::pair<std::string, std::string> parseOddArguments(const std::string&
 }
 
 bool parseCommandLineArguments(int argc, char* argv[], caprica::CapricaJobManager* jobManager) {
+  bool workersStarted = false;
   try {
     bool iterateCompiledDirectoriesRecursively = false;
 
@@ -85,7 +94,14 @@ bool parseCommandLineArguments(int argc, char* argv[], caprica::CapricaJobManage
                                        "Load additional options from a config file.")(
         "quiet,q",
         po::bool_switch(&conf::General::quietCompile)->default_value(false),
-        "Do not report progress, only failures.")("strict",
+        "Do not report progress, only failures.")(
+        "diagnostics-format",
+        po::value<std::string>()->default_value("text"),
+        "Also write errors and warnings to a structured file. Valid values are: text, json, sarif. (default: text)")(
+        "diagnostics-output",
+        po::value<std::string>(),
+        "Set the file to write structured diagnostics to. (default: caprica.diagnostics.json or "
+        "caprica.diagnostics.sarif in the output directory)")("strict",
                                                   po::value<bool>()->default_value(false)->implicit_value(true),
                                                   "Enable strict checking of control flow, poisoning, and more sane "
                                                   "implicit conversions. It is strongly recommended to enable these.");
@@ -143,10 +159,15 @@ bool parseCommandLineArguments(int argc, char* argv[], caprica::CapricaJobManage
                                "Allow a negative literal number to be parsed as a binary op.")(
         "async-read",
         po::value<bool>(&conf::Performance::asyncFileRead)->default_value(true),
-        "Allow async file reading. This is primarily useful on SSDs.")(
+        "Allow async file reading. This is primarily useful on SSDs. Defaults to false when only loose "
+        "files are compiled, so that only the imports they refer to are read.")(
         "async-write",
         po::value<bool>(&conf::Performance::asyncFileWrite)->default_value(true),
         "Allow writing output to disk on background threads.")(
+        "check-only",
+        po::bool_switch(&conf::General::checkOnly)->default_value(false),
+        "Only check the input files for errors and warnings, stopping after semantic analysis without "
+        "generating or writing any output.")(
         "dump-asm",
         po::bool_switch(&conf::Debug::dumpPexAsm)->default_value(false),
         "Dump the PEX assembly code for the input files.")(
@@ -160,15 +181,41 @@ bool parseCommandLineArguments(int argc, char* argv[], caprica::CapricaJobManage
         "enable-language-extensions",
         po::value<bool>(&conf::Papyrus::enableLanguageExtensions)->default_value(false),
         "Enable Caprica's extensions to the Papyrus language.")(
+        "import-pex",
+        po::bool_switch(&conf::Papyrus::importPexFiles)->default_value(false),
+        "Also import compiled .pex files from the import directories, for scripts that don't have a .psc next to "
+        "them. Only the interface of the compiled script is read.")(
+        "reproducible",
+        po::bool_switch(&conf::CodeGeneration::reproducible)->default_value(false),
+        "Make the output depend only on the input, by leaving out the user and computer names, writing the "
+        "source path relative to its input or import directory, and writing SOURCE_DATE_EPOCH, or 0 if it "
+        "isn't set, as the compilation and modification times.")(
         "resolve-symlinks",
         po::value<bool>(&conf::Performance::resolveSymlinks)->default_value(false),
-        "Fully resolve symlinks when determining file paths.");
+        "Fully resolve symlinks when determining file paths.")(
+        "strip-user-info",
+        po::bool_switch(&conf::CodeGeneration::stripUserInfo)->default_value(false),
+        "Leave the user and computer names out of the compiled scripts.")(
+        "transform-pex",
+        po::bool_switch(&conf::General::transformPex)->default_value(false),
+        "Treat the input files as compiled .pex files, and write them back out to the output directory after "
+        "applying -O, --enable-debug-info=false and --strip-user-info to them.")(
+        "trace-out",
+        po::value<std::string>(&conf::Performance::traceOutputFile),
+        "Write a Chrome trace of the time spent reading, parsing, checking, compiling and writing each file, "
+        "and of the time each worker spent blocked or idle, to the given file.")(
+        "memory-report",
+        po::bool_switch(&conf::Performance::memoryReport)->default_value(false),
+        "Report the peak memory use, the memory used by each kind of allocation and in each phase of the "
+        "compile, and the scripts that needed the most memory.");
 
     po::options_description hiddenDesc("");
     hiddenDesc.add_options()("input-file", po::value<std::vector<std::string>>(), "The input file.")
 
         // These are intended for debugging, not general use.
-        ("force-enable-optimizations", po::bool_switch()->default_value(false), "Force optimizations to be enabled.")(
+        ("force-enable-optimizations",
+         po::bool_switch(&conf::CodeGeneration::forceEnableOptimizations)->default_value(false),
+         "Force optimizations to be enabled.")(
             "debug-control-flow-graph",
             po::value<bool>(&conf::Debug::debugControlFlowGraph)->default_value(false),
             "Dump the control flow graph for every function to std::cout.")(
@@ -281,6 +328,18 @@ bool parseCommandLineArguments(int argc, char* argv[], caprica::CapricaJobManage
       return false;
     }
 
+    std::string diagnosticsFormat = vm["diagnostics-format"].as<std::string>();
+    if (_stricmp(diagnosticsFormat.c_str(), "text") == 0) {
+      conf::General::diagnosticsFormat = conf::General::DiagnosticsFormat::Text;
+    } else if (_stricmp(diagnosticsFormat.c_str(), "json") == 0) {
+      conf::General::diagnosticsFormat = conf::General::DiagnosticsFormat::Json;
+    } else if (_stricmp(diagnosticsFormat.c_str(), "sarif") == 0) {
+      conf::General::diagnosticsFormat = conf::General::DiagnosticsFormat::Sarif;
+    } else {
+      std::cout << "Unrecognized diagnostics format '" << diagnosticsFormat << "'!" << std::endl;
+      return false;
+    }
+
     if (conf::Papyrus::game != GameID::Skyrim) {
       // turn off skyrim options
       conf::Skyrim::skyrimAllowUnknownEventsOnNonNativeClass = false;
@@ -290,8 +349,9 @@ bool parseCommandLineArguments(int argc, char* argv[], caprica::CapricaJobManage
     }
 
     // TODO: enable this eventually
-    if (vm["optimize"].as<bool>() && conf::Papyrus::game != GameID::Fallout4) {
-      if (!vm["force-enable-optimizations"].as<bool>()) {
+    // Transformed .pex files are checked one by one, against the game they were compiled for.
+    if (vm["optimize"].as<bool>() && conf::Papyrus::game != GameID::Fallout4 && !conf::General::transformPex) {
+      if (!conf::CodeGeneration::forceEnableOptimizations) {
         conf::CodeGeneration::enableOptimizations = false;
         std::cout << "Warning: Optimization is currently only supported for Fallout 4, disabling..." << std::endl;
       } else {
@@ -301,6 +361,18 @@ bool parseCommandLineArguments(int argc, char* argv[], caprica::CapricaJobManage
       }
     }
 
+    if (conf::CodeGeneration::reproducible) {
+      conf::CodeGeneration::stripUserInfo = true;
+      if (auto epoch = std::getenv("SOURCE_DATE_EPOCH")) {
+        char* end;
+        conf::CodeGeneration::reproducibleTimestamp = (time_t)std::strtoll(epoch, &end, 10);
+        if (*epoch == '\0' || *end != '\0') {
+          std::cout << "Invalid SOURCE_DATE_EPOCH '" << epoch << "'!" << std::endl;
+          return false;
+        }
+      }
+    }
+
     if (vm["champollion-compat"].as<bool>()) {
       conf::Papyrus::allowCompilerIdentifiers = true;
       conf::Papyrus::allowDecompiledStructNameRefs = true;
@@ -365,6 +437,20 @@ bool parseCommandLineArguments(int argc, char* argv[], caprica::CapricaJobManage
       filesystem::create_directories(baseOutputDir);
     baseOutputDir = FSUtils::canonical(baseOutputDir);
 
+    if (vm.count("diagnostics-output")) {
+      conf::General::diagnosticsOutputFile = vm["diagnostics-output"].as<std::string>();
+    } else if (conf::General::diagnosticsFormat == conf::General::DiagnosticsFormat::Sarif) {
+      conf::General::diagnosticsOutputFile = baseOutputDir + "\\caprica.diagnostics.sarif";
+    } else {
+      conf::General::diagnosticsOutputFile = baseOutputDir + "\\caprica.diagnostics.json";
+    }
+
+    if (conf::General::checkOnly && conf::General::transformPex) {
+      std::cout << "--check-only can't be combined with --transform-pex!" << std::endl;
+      return false;
+    }
+
+    std::string flagsPath {};
     if (vm.count("flags")) {
       const auto findFlags = [progamBasePath, baseOutputDir](const std::string& flagsPath) -> std::string {
         if (filesystem::exists(flagsPath))
@@ -382,53 +468,96 @@ bool parseCommandLineArguments(int argc, char* argv[], caprica::CapricaJobManage
         return "";
       };
 
-      auto flagsPath = findFlags(vm["flags"].as<std::string>());
+      flagsPath = findFlags(vm["flags"].as<std::string>());
       if (flagsPath == "") {
         std::cout << "Unable to locate flags file '" << vm["flags"].as<std::string>() << "'." << std::endl;
         return false;
       }
-
-      parseUserFlags(std::move(flagsPath));
-    }
-
-    if (!handleImports(conf::Papyrus::importDirectories, jobManager)) {
-      std::cout << "Import failed!" << std::endl;
-      return false;
     }
 
+    using NodeType = caprica::papyrus::PapyrusCompilationNode::NodeType;
+    auto inputNodeType = conf::General::transformPex ? NodeType::PexTransform : NodeType::PapyrusCompile;
     auto filesPassed = vm["input-file"].as<std::vector<std::string>>();
     for (auto& f : filesPassed) {
       if (!filesystem::exists(f)) {
         std::cout << "Unable to locate input file '" << f << "'." << std::endl;
         return false;
       }
-      if (filesystem::is_directory(f)) {
-        if (!addFilesFromDirectory(f,
-                                   iterateCompiledDirectoriesRecursively,
-                                   baseOutputDir,
-                                   jobManager,
-                                   caprica::papyrus::PapyrusCompilationNode::NodeType::PapyrusCompile)) {
+      if (filesystem::is_directory(f))
+        continue;
+      std::string_view ext = FSUtils::extensionAsRef(f);
+      if (conf::General::transformPex && !pathEq(ext, ".pex")) {
+        std::cout << "Don't know how to transform input file '" << f << "'!" << std::endl;
+        std::cout << "Only Pex files (*.pex) can be transformed!" << std::endl;
+        return false;
+      }
+      if (!pathEq(ext, ".psc") && !pathEq(ext, ".pas") && !pathEq(ext, ".pex")) {
+        std::cout << "Don't know how to handle input file '" << f << "'!" << std::endl;
+        std::cout << "Expected either a Papyrus file (*.psc), Pex assembly file (*.pas), or a Pex file (*.pex)!"
+                  << std::endl;
+        return false;
+      }
+    }
+
+    // When only loose files are compiled, they usually refer to a small part of the
+    // imports, so unless asked otherwise, an import is only read once a file being
+    // compiled refers to it, directly or through another import.
+    if (vm["async-read"].defaulted() && !conf::Performance::performanceTestMode) {
+      if (std::none_of(filesPassed.begin(), filesPassed.end(), [](const std::string& f) {
+            return filesystem::is_directory(f);
+          }))
+        conf::Performance::asyncFileRead = false;
+    }
+
+    // Everything has been validated and configured by now, so start the
+    // workers, and then parse the user flags and scan the directories on them.
+    // From here on, the workers have to be stopped before failing, as they
+    // refer to the job manager.
+    startWorkers(jobManager);
+    workersStarted = true;
+
+    if (!flagsPath.empty())
+      queueUserFlagsParse(std::move(flagsPath), jobManager);
+
+    // The input directories are scanned along with the import directories,
+    // but added after them, in the order they were given in, along with the
+    // loose files.
+    std::vector<DirectoryScanJob*> scanJobs(filesPassed.size(), nullptr);
+    for (size_t i = 0; i < filesPassed.size(); i++) {
+      if (filesystem::is_directory(filesPassed[i]))
+        scanJobs[i] = queueDirectoryScan(filesPassed[i],
+                                         iterateCompiledDirectoriesRecursively,
+                                         baseOutputDir,
+                                         jobManager,
+                                         inputNodeType);
+    }
+
+    if (!handleImports(conf::Papyrus::importDirectories, jobManager)) {
+      std::cout << "Import failed!" << std::endl;
+      stopWorkers(jobManager);
+      return false;
+    }
+
+    for (size_t i = 0; i < filesPassed.size(); i++) {
+      auto& f = filesPassed[i];
+      if (scanJobs[i]) {
+        if (!awaitDirectoryScan(scanJobs[i])) {
+          stopWorkers(jobManager);
           return false;
         }
       } else {
         std::cout << "WARNING: Loose input files are assumed as being in the root namespace." << std::endl;
-        std::string_view ext = FSUtils::extensionAsRef(f);
-        if (!pathEq(ext, ".psc") && !pathEq(ext, ".pas") && !pathEq(ext, ".pex")) {
-          std::cout << "Don't know how to handle input file '" << f << "'!" << std::endl;
-          std::cout << "Expected either a Papyrus file (*.psc), Pex assembly file (*.pas), or a Pex file (*.pex)!"
-                    << std::endl;
-          return false;
-        }
         auto oDir = baseOutputDir;
-        addSingleFile(std::move(f),
-                      std::move(oDir),
-                      jobManager,
-                      caprica::papyrus::PapyrusCompilationNode::NodeType::PapyrusCompile);
+        addSingleFile(std::move(f), std::move(oDir), jobManager, inputNodeType);
       }
     }
+
+    awaitUserFlagsParse();
   } catch (const std::exception& ex) {
     if (ex.what() != std::string(""))
       std::cout << ex.what() << std::endl;
+    if (workersStarted)
+      stopWorkers(jobManager);
     return false;
   }
 
@@ -77,7 +77,7 @@ void PapyrusControlFlowNode::dumpNode(int currentDepth) {
   }
 }
 
-bool PapyrusCFG::processStatements(const IntrusiveLinkedList<statements::PapyrusStatement>& stmts) {
+bool PapyrusCFG::processStatements(const ArenaSpan<statements::PapyrusStatement>& stmts) {
   bool wasTerminal = false;
   for (auto s : stmts) {
     if (s->buildCFG(*this)) {
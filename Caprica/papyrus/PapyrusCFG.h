@@ -3,6 +3,7 @@
 #include <stack>
 
 #include <common/allocators/ChainedPool.h>
+#include <common/ArenaPtr.h>
 #include <common/CapricaReportingContext.h>
 #include <common/IntrusiveLinkedList.h>
 #include <common/IntrusiveStack.h>
@@ -55,9 +56,9 @@ struct PapyrusCFG final {
   }
   ~PapyrusCFG() = default;
 
-  bool processStatements(const IntrusiveLinkedList<statements::PapyrusStatement>& stmts);
+  bool processStatements(const ArenaSpan<statements::PapyrusStatement>& stmts);
 
-  bool processCommonLoopBody(const IntrusiveLinkedList<statements::PapyrusStatement>& stmts) {
+  bool processCommonLoopBody(const ArenaSpan<statements::PapyrusStatement>& stmts) {
     pushBreakTerminal();
     addLeaf();
     bool wasTerminal = processStatements(stmts);
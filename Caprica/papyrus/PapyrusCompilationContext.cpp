@@ -1,15 +1,20 @@
 #include <papyrus/PapyrusCompilationContext.h>
 
+#include <deque>
 #include <fcntl.h>
 #include <filesystem>
 #include <io.h>
 #include <iostream>
+#include <sstream>
 
-#include <common/allocators/AtomicChainedPool.h>
+#include <common/allocators/PerThreadPool.h>
 #include <common/CapricaConfig.h>
+#include <common/CapricaMemoryReport.h>
+#include <common/CapricaTrace.h>
 #include <common/FakeScripts.h>
 
 #include <papyrus/parser/PapyrusParser.h>
+#include <papyrus/PapyrusWorkerContext.h>
 
 #include <pex/parser/PexAsmParser.h>
 #include <pex/PexOptimizer.h>
@@ -38,6 +43,10 @@ void PapyrusCompilationNode::queueCompile() {
     case NodeType::PexReflection:
       return;
   }
+  // Nodes are queued from the main thread in a fixed order,
+  // which is the order their diagnostics are reported in.
+  static size_t nextReportOrder { 0 };
+  reportingContext.setReportOrder(nextReportOrder++);
   jobManager->queueJob(&writeJob);
 }
 
@@ -52,10 +61,13 @@ void PapyrusCompilationNode::awaitWrite() {
   writeJob.await();
 }
 
-allocators::AtomicChainedPool readAllocator { 1024 * 1024 * 4 };
+// Every read job allocates from this, so each thread reads into chunks of its own.
+allocators::PerThreadPool readAllocator { 1024 * 1024, MemoryOwner::ReadBuffers };
 void PapyrusCompilationNode::FileReadJob::run() {
+  CapricaTrace::Scope trace { CapricaTrace::Category::Job, "Read", parent->reportedName };
+  CapricaMemoryReport::PhaseScope memoryPhase { CapricaMemoryReport::Phase::Read };
   if (parent->type == NodeType::PapyrusCompile || parent->type == NodeType::PasCompile ||
-      parent->type == NodeType::PexDissassembly) {
+      parent->type == NodeType::PexDissassembly || parent->type == NodeType::PexTransform) {
     if (!conf::General::quietCompile)
       std::cout << "Compiling " << parent->reportedName << std::endl;
   }
@@ -105,6 +117,8 @@ void PapyrusCompilationNode::FileReadJob::run() {
 }
 
 void PapyrusCompilationNode::FileParseJob::run() {
+  CapricaTrace::Scope trace { CapricaTrace::Category::Job, "Parse", parent->reportedName };
+  CapricaMemoryReport::PhaseScope memoryPhase { CapricaMemoryReport::Phase::Parse };
   parent->readJob.await();
   bool isPexFile = false;
   auto ext = FSUtils::extensionAsRef(parent->sourceFilePath);
@@ -115,11 +129,13 @@ void PapyrusCompilationNode::FileParseJob::run() {
       parent->reportingContext.exitIfErrors();
     delete parser;
   } else if (pathEq(ext, ".pex")) {
-    pex::PexReader rdr(parent->sourceFilePath);
-    auto alloc = new allocators::ChainedPool(1024 * 4);
+    pex::PexReader rdr(parent->readFileData);
+    // Reflection only needs the file's interface, not its code.
+    rdr.interfaceOnly = parent->type == NodeType::PexReflection;
+    auto alloc = new allocators::ChainedPool(1024 * 4, MemoryOwner::PexFile);
     parent->pexFile = pex::PexFile::read(alloc, rdr);
     isPexFile = true;
-    if (parent->type == NodeType::PexDissassembly)
+    if (parent->type == NodeType::PexDissassembly || parent->type == NodeType::PexTransform)
       return;
   } else if (pathEq(ext, ".pas")) {
     auto parser = new pex::parser::PexAsmParser(parent->reportingContext, parent->sourceFilePath);
@@ -148,6 +164,8 @@ void PapyrusCompilationNode::FileParseJob::run() {
   parent->resolutionContext = new PapyrusResolutionContext(parent->reportingContext);
   parent->resolutionContext->allocator = parent->loadedScript->allocator;
   parent->resolutionContext->isPexResolution = isPexFile;
+  if (conf::General::compileInParallel && parent->type == NodeType::PapyrusCompile)
+    parent->resolutionContext->jobManager = parent->jobManager;
   parent->loadedScript->preSemantic(parent->resolutionContext);
   parent->reportingContext.exitIfErrors();
 
@@ -157,7 +175,13 @@ void PapyrusCompilationNode::FileParseJob::run() {
 }
 
 void PapyrusCompilationNode::FileSemanticJob::run() {
+  CapricaTrace::Scope trace { CapricaTrace::Category::Job, "Semantic", parent->reportedName };
+  CapricaMemoryReport::PhaseScope memoryPhase { CapricaMemoryReport::Phase::Semantic };
   parent->parseJob.await();
+  // Disassembly, .pex transforms and .pas compiles work on the PexFile
+  // directly and never build a script, so they don't depend on any other file.
+  if (!parent->loadedScript)
+    return;
   parent->loadedScript->semantic(parent->resolutionContext);
   if (parent->type != NodeType::PapyrusImport)
     parent->reportingContext.exitIfErrors();
@@ -165,7 +189,22 @@ void PapyrusCompilationNode::FileSemanticJob::run() {
 
 static constexpr bool disablePexBuild = false;
 
+// Like the .pex files, the assembly is written in one go, so a killed
+// build can't leave a truncated file behind.
+static void writeAsmFile(const std::string& outputDirectory, std::string_view baseName, const pex::PexFile* pexFile) {
+  auto containingDir = std::filesystem::path(outputDirectory);
+  if (!std::filesystem::exists(containingDir))
+    std::filesystem::create_directories(containingDir);
+  std::ostringstream asmStrm;
+  pex::PexAsmWriter asmWtr(asmStrm);
+  pexFile->writeAsm(asmWtr);
+  auto text = asmStrm.str();
+  FSUtils::writeFileAtomically(outputDirectory + "\\" + std::string(baseName) + ".pas", text.data(), text.size());
+}
+
 void PapyrusCompilationNode::FileCompileJob::run() {
+  CapricaTrace::Scope trace { CapricaTrace::Category::Job, "Compile", parent->reportedName };
+  CapricaMemoryReport::PhaseScope memoryPhase { CapricaMemoryReport::Phase::Compile };
   parent->semanticJob.await();
   switch (parent->type) {
     case NodeType::PapyrusCompile: {
@@ -173,53 +212,87 @@ void PapyrusCompilationNode::FileCompileJob::run() {
       parent->reportingContext.exitIfErrors();
       delete parent->resolutionContext;
       parent->resolutionContext = nullptr;
+      // The script has passed every check we can do,
+      // so there's nothing left to do for --check-only.
+      if (conf::General::checkOnly)
+        return;
 
       if (!disablePexBuild) {
-        parent->pexFile = parent->loadedScript->buildPex(parent->reportingContext);
+        auto pexJobManager = conf::General::compileInParallel ? parent->jobManager : nullptr;
+        parent->pexFile = parent->loadedScript->buildPex(parent->reportingContext, pexJobManager);
         parent->reportingContext.exitIfErrors();
 
         if (conf::CodeGeneration::enableOptimizations)
           pex::PexOptimizer::optimize(parent->pexFile);
 
-        parent->pexWriter = new pex::PexWriter();
+        parent->pexWriter = PapyrusWorkerContext::current().pexWriters.acquire();
         parent->pexFile->write(*parent->pexWriter);
 
-        if (conf::Debug::dumpPexAsm) {
-          auto baseFileName = std::string(FSUtils::basenameAsRef(parent->sourceFilePath));
-          auto containingDir = std::filesystem::path(parent->outputDirectory);
-          if (!std::filesystem::exists(containingDir))
-            std::filesystem::create_directories(containingDir);
-          std::ofstream asmStrm(parent->outputDirectory + "\\" + std::string(parent->baseName) + ".pas",
-                                std::ofstream::binary);
-          asmStrm.exceptions(std::ifstream::badbit | std::ifstream::failbit);
-          pex::PexAsmWriter asmWtr(asmStrm);
-          parent->pexFile->writeAsm(asmWtr);
+        if (CapricaMemoryReport::enabled()) {
+          CapricaMemoryReport::recordScript(parent->reportedName,
+                                            parent->loadedScript->allocator->totalAllocatedBytes(),
+                                            parent->pexFile->alloc->totalAllocatedBytes(),
+                                            parent->pexWriter->size());
         }
 
+        if (conf::Debug::dumpPexAsm)
+          writeAsmFile(parent->outputDirectory, parent->baseName, parent->pexFile);
+
         delete parent->pexFile->alloc;
         parent->pexFile = nullptr;
       }
       return;
     }
     case NodeType::PexDissassembly: {
-      auto baseFileName = std::string(FSUtils::basenameAsRef(parent->sourceFilePath));
-      auto containingDir = std::filesystem::path(parent->outputDirectory);
-      if (!std::filesystem::exists(containingDir))
-        std::filesystem::create_directories(containingDir);
-      std::ofstream asmStrm(parent->outputDirectory + "\\" + std::string(parent->baseName) + ".pas",
-                            std::ofstream::binary);
-      asmStrm.exceptions(std::ifstream::badbit | std::ifstream::failbit);
-      caprica::pex::PexAsmWriter asmWtr(asmStrm);
-      parent->pexFile->writeAsm(asmWtr);
+      if (conf::General::checkOnly) {
+        delete parent->pexFile->alloc;
+        parent->pexFile = nullptr;
+        return;
+      }
+      writeAsmFile(parent->outputDirectory, parent->baseName, parent->pexFile);
+      delete parent->pexFile->alloc;
+      parent->pexFile = nullptr;
+      return;
+    }
+    case NodeType::PexTransform: {
+      if (conf::CodeGeneration::enableOptimizations) {
+        // Like for a compile, the optimizer is only trusted with Fallout 4 scripts.
+        if (parent->pexFile->gameID == GameID::Fallout4 || conf::CodeGeneration::forceEnableOptimizations) {
+          pex::PexOptimizer::optimize(parent->pexFile);
+        } else {
+          parent->reportingContext.warning_W8000_Transform_Optimization_Unsupported_Game(
+              GameIDToString(parent->pexFile->gameID));
+        }
+      }
+      if (!conf::CodeGeneration::emitDebugInfo)
+        parent->pexFile->debugInfo = nullptr;
+      if (conf::CodeGeneration::stripUserInfo) {
+        parent->pexFile->userName = "";
+        parent->pexFile->computerName = "";
+      }
+      if (conf::CodeGeneration::reproducible) {
+        if (parent->pexFile->debugInfo)
+          parent->pexFile->debugInfo->modificationTime = conf::CodeGeneration::reproducibleTimestamp;
+        parent->pexFile->compilationTime = conf::CodeGeneration::reproducibleTimestamp;
+      }
+
+      parent->pexWriter = PapyrusWorkerContext::current().pexWriters.acquire();
+      parent->pexFile->write(*parent->pexWriter);
       delete parent->pexFile->alloc;
       parent->pexFile = nullptr;
       return;
     }
     case NodeType::PasCompile: {
+      // Parsing the assembly is the only check done on it.
+      if (conf::General::checkOnly) {
+        delete parent->pexFile->alloc;
+        parent->pexFile = nullptr;
+        return;
+      }
       if (conf::CodeGeneration::enableOptimizations)
         pex::PexOptimizer::optimize(parent->pexFile);
 
-      parent->pexWriter = new pex::PexWriter();
+      parent->pexWriter = PapyrusWorkerContext::current().pexWriters.acquire();
       parent->pexFile->write(*parent->pexWriter);
       delete parent->pexFile->alloc;
       parent->pexFile = nullptr;
@@ -239,21 +312,29 @@ void PapyrusCompilationNode::FileCompileJob::run() {
 }
 
 void PapyrusCompilationNode::FileWriteJob::run() {
+  CapricaTrace::Scope trace { CapricaTrace::Category::Job, "Write", parent->reportedName };
+  CapricaMemoryReport::PhaseScope memoryPhase { CapricaMemoryReport::Phase::Write };
   parent->compileJob.await();
   switch (parent->type) {
     case NodeType::PasCompile:
-    case NodeType::PapyrusCompile: {
+    case NodeType::PapyrusCompile:
+    case NodeType::PexTransform: {
+      if (conf::General::checkOnly) {
+        parent->reportingContext.submitDiagnostics();
+        return;
+      }
       if (!conf::Performance::performanceTestMode) {
         auto baseFileName = std::string(FSUtils::basenameAsRef(parent->sourceFilePath));
         auto containingDir = std::filesystem::path(parent->outputDirectory);
         if (!std::filesystem::exists(containingDir))
           std::filesystem::create_directories(containingDir);
-        std::ofstream destFile { parent->outputDirectory + "\\" + baseFileName + ".pex", std::ifstream::binary };
-        destFile.exceptions(std::ifstream::badbit | std::ifstream::failbit);
-        parent->pexWriter->applyToBuffers([&](const char* data, size_t size) { destFile.write(data, size); });
+        FSUtils::writeFileAtomically(parent->outputDirectory + "\\" + baseFileName + ".pex",
+                                     parent->pexWriter->data(),
+                                     parent->pexWriter->size());
       }
-      delete parent->pexWriter;
+      PapyrusWorkerContext::current().pexWriters.release(parent->pexWriter);
       parent->pexWriter = nullptr;
+      parent->reportingContext.submitDiagnostics();
       return;
     }
     // TODO: remove this hack
@@ -261,6 +342,7 @@ void PapyrusCompilationNode::FileWriteJob::run() {
     case NodeType::PexDissassembly:
     case NodeType::PasReflection:
     case NodeType::PexReflection:
+      parent->reportingContext.submitDiagnostics();
       return;
     case NodeType::Unknown:
     default:
@@ -271,153 +353,143 @@ void PapyrusCompilationNode::FileWriteJob::run() {
 
 namespace {
 
-struct PapyrusNamespace final {
-  std::string name { "" };
-  PapyrusNamespace* parent { nullptr };
-  caseless_unordered_identifier_ref_map<PapyrusNamespace*> children {};
-  // Key is unqualified name, value is full path to file.
-  caseless_unordered_identifier_ref_map<PapyrusCompilationNode*> objects {};
-
-  void awaitRead() {
-    for (auto o : objects)
-      o.second->awaitRead();
-    for (auto c : children)
-      c.second->awaitRead();
-  }
-
-  void queueCompile() {
-    for (auto o : objects)
-      o.second->queueCompile();
-    for (auto c : children)
-      c.second->queueCompile();
-  }
-
-  void awaitCompile() {
-    for (auto o : objects)
-      o.second->awaitWrite();
-    for (auto c : children)
-      c.second->awaitCompile();
+// Every script and namespace, by fully qualified name. The namespaces are
+// only there so that we can tell a script in a sub-namespace from a struct
+// in a script. It's filled while the input and import directories are
+// scanned, before any node is queued, and is only read after that, so the
+// nodes can look types up in it without locking.
+struct PapyrusNamespaceDirectory final {
+  void addNamespace(const std::string& namespaceName) {
+    if (conf::Papyrus::game == GameID::Skyrim && namespaceName != "")
+      CapricaReportingContext::logicalFatal("Invalid namespacing on Skyrim script: %s", namespaceName.c_str());
+
+    // Add the parent namespaces as well, so that every prefix
+    // of a namespace that exists is a namespace.
+    size_t loc = 0;
+    while (true) {
+      loc = namespaceName.find(':', loc);
+      auto& e = findOrAdd(namespaceName.substr(0, loc));
+      e.isNamespace = true;
+      if (loc == std::string::npos)
+        break;
+      loc++;
+    }
   }
 
-  void createNamespace(const identifier_ref& curPiece,
-                       caseless_unordered_identifier_ref_map<PapyrusCompilationNode*>&& map) {
-    if (conf::Papyrus::game == GameID::Skyrim && curPiece != "")
-      CapricaReportingContext::logicalFatal("Invalid namespacing on Skyrim script: %s", curPiece.to_string().c_str());
-    if (curPiece == "") {
-      if (!objects.empty()) {
-        // we have to merge them
-        for (auto& obj : map) {
-          auto f = objects.find(obj.first);
-          if (f != objects.end()) {
-            // we have a duplicate
-            if (_stricmp(f->second->baseName.data(), obj.second->baseName.data()) == 0) {
-              // we have a problem
-              CapricaReportingContext::logicalFatal("Conflicting script name: %s", obj.first.to_string().c_str());
-            }
-          } else {
-            // we don't have a duplicate, so we can just add it
-            objects.emplace(std::move(obj.first), std::move(obj.second));
-          }
-        }
-      } else {
-        // we don't have any objects, so we can just move the map
-        objects = std::move(map);
+  void addScripts(const std::string& namespaceName,
+                  caseless_unordered_identifier_ref_map<PapyrusCompilationNode*>&& map) {
+    addNamespace(namespaceName);
+    for (auto& obj : map) {
+      std::string qualifiedName {};
+      qualify(qualifiedName, namespaceName, obj.first);
+      auto& e = findOrAdd(std::move(qualifiedName));
+      if (e.node) {
+        // If it's the same file imported again, we have a problem,
+        // otherwise the first one found wins.
+        if (_stricmp(e.node->baseName.data(), obj.second->baseName.data()) == 0)
+          CapricaReportingContext::logicalFatal("Conflicting script name: %s", obj.first.to_string().c_str());
+        continue;
       }
-      return;
-    }
-
-    identifier_ref curSearchPiece = curPiece;
-    identifier_ref nextSearchPiece = "";
-    auto loc = curPiece.find(':');
-    if (loc != identifier_ref::npos) {
-      curSearchPiece = curPiece.substr(0, loc);
-      nextSearchPiece = curPiece.substr(loc + 1);
+      e.node = obj.second;
+      nodes.push_back(obj.second);
     }
+  }
 
-    auto f = children.find(curSearchPiece);
-    if (f == children.end()) {
-      auto n = new PapyrusNamespace();
-      n->name = curSearchPiece.to_string();
-      n->parent = this;
-      children.emplace(n->name, n);
-      f = children.find(curSearchPiece);
-    }
-    f->second->createNamespace(nextSearchPiece, std::move(map));
+  bool isNamespace(const identifier_ref& namespaceName) const {
+    auto f = entries.find(namespaceName);
+    return f != entries.end() && f->second.isNamespace;
   }
 
-  bool tryFindNamespace(const identifier_ref& curPiece, PapyrusNamespace const** ret) const {
-    if (curPiece == "") {
-      *ret = this;
+  // Looks a possibly qualified type name up relative to a single namespace.
+  bool tryFindType(const identifier_ref& namespaceName,
+                   const identifier_ref& typeName,
+                   PapyrusCompilationNode** retNode,
+                   identifier_ref* retStructName) const {
+    thread_local std::string qualifiedName {};
+    qualify(qualifiedName, namespaceName, typeName);
+    if (auto node = tryFindScript(qualifiedName)) {
+      *retNode = node;
       return true;
     }
 
-    identifier_ref curSearchPiece = curPiece;
-    identifier_ref nextSearchPiece = "";
-    auto loc = curPiece.find(':');
-    if (loc != identifier_ref::npos) {
-      curSearchPiece = curPiece.substr(0, loc);
-      nextSearchPiece = curPiece.substr(loc + 1);
+    // Otherwise it might be a struct in a script, as long as the
+    // script's name doesn't also name a namespace, in which case
+    // it's a script in that namespace that doesn't exist.
+    auto loc = typeName.rfind(':');
+    if (loc == identifier_ref::npos)
+      return false;
+    auto scriptName = identifier_ref(qualifiedName).substr(0, qualifiedName.size() - typeName.size() + loc);
+    if (isNamespace(scriptName))
+      return false;
+    if (auto node = tryFindScript(scriptName)) {
+      *retNode = node;
+      *retStructName = typeName.substr(loc + 1);
+      return true;
     }
-
-    auto f = children.find(curSearchPiece);
-    if (f != children.end())
-      return f->second->tryFindNamespace(nextSearchPiece, ret);
-
     return false;
   }
 
-  bool
-  tryFindType(const identifier_ref& typeName, PapyrusCompilationNode** retNode, identifier_ref* retStructName) const {
-    auto loc = typeName.find(':');
-    if (loc == identifier_ref::npos) {
-      auto f2 = objects.find(typeName);
-      if (f2 != objects.end()) {
-        *retNode = f2->second;
-        return true;
-      }
-      return false;
-    }
-
-    // It's a partially qualified type name, or else is referencing
-    // a struct.
-    auto baseName = typeName.substr(0, loc);
-    auto subName = typeName.substr(loc + 1);
-
-    // It's a partially qualified name.
-    auto f = children.find(baseName);
-    if (f != children.end())
-      return f->second->tryFindType(subName, retNode, retStructName);
+  void awaitRead() const {
+    for (auto n : nodes)
+      n->awaitRead();
+  }
 
-    // subName is still partially qualified, so it can't
-    // be referencing a struct in this namespace.
-    if (subName.find(':') != identifier_ref::npos)
-      return false;
+  void queueCompile() const {
+    for (auto n : nodes)
+      n->queueCompile();
+  }
 
-    // It is a struct reference.
-    auto f2 = objects.find(baseName);
-    if (f2 != objects.end()) {
-      *retNode = f2->second;
-      *retStructName = subName;
-      return true;
+private:
+  struct Entry final {
+    PapyrusCompilationNode* node { nullptr };
+    bool isNamespace { false };
+  };
+
+  // Owns the names the keys of `entries` refer to. A deque so that
+  // adding a name never moves the ones already there.
+  std::deque<std::string> names {};
+  caseless_unordered_identifier_ref_map<Entry> entries {};
+  std::vector<PapyrusCompilationNode*> nodes {};
+
+  static void qualify(std::string& out, const identifier_ref& namespaceName, const identifier_ref& name) {
+    out.clear();
+    if (!namespaceName.empty()) {
+      out.append(namespaceName.data(), namespaceName.size());
+      out.push_back(':');
     }
+    out.append(name.data(), name.size());
+  }
 
-    return false;
+  Entry& findOrAdd(std::string&& qualifiedName) {
+    auto f = entries.find(qualifiedName);
+    if (f != entries.end())
+      return f->second;
+    names.push_back(std::move(qualifiedName));
+    return entries.emplace(identifier_ref(names.back()), Entry {}).first->second;
+  }
+
+  PapyrusCompilationNode* tryFindScript(const identifier_ref& qualifiedName) const {
+    auto f = entries.find(qualifiedName);
+    if (f != entries.end())
+      return f->second.node;
+    return nullptr;
   }
 };
+
 }
 
-static PapyrusNamespace rootNamespace {};
+static PapyrusNamespaceDirectory namespaceDirectory {};
 void PapyrusCompilationContext::pushNamespaceFullContents(
     const std::string& namespaceName, caseless_unordered_identifier_ref_map<PapyrusCompilationNode*>&& map) {
-  rootNamespace.createNamespace(namespaceName, std::move(map));
+  namespaceDirectory.addScripts(namespaceName, std::move(map));
 }
 
 void PapyrusCompilationContext::awaitRead() {
-  rootNamespace.awaitRead();
+  namespaceDirectory.awaitRead();
 }
 
 void PapyrusCompilationContext::doCompile(CapricaJobManager* jobManager) {
-  rootNamespace.queueCompile();
+  namespaceDirectory.queueCompile();
   jobManager->setQueueInitialized();
   jobManager->enjoin();
 }
@@ -426,16 +498,19 @@ bool PapyrusCompilationContext::tryFindType(const identifier_ref& baseNamespace,
                                             const identifier_ref& typeName,
                                             PapyrusCompilationNode** retNode,
                                             identifier_ref* retStructName) {
-  const PapyrusNamespace* curNamespace = nullptr;
-  if (!rootNamespace.tryFindNamespace(baseNamespace, &curNamespace))
+  if (!namespaceDirectory.isNamespace(baseNamespace))
     return false;
 
-  while (curNamespace != nullptr) {
-    if (curNamespace->tryFindType(typeName, retNode, retStructName))
+  // Search the namespace the reference is in first, then each of its parents.
+  auto curNamespace = baseNamespace;
+  while (true) {
+    if (namespaceDirectory.tryFindType(curNamespace, typeName, retNode, retStructName))
       return true;
-    curNamespace = curNamespace->parent;
+    if (curNamespace.empty())
+      return false;
+    auto loc = curNamespace.rfind(':');
+    curNamespace = loc == identifier_ref::npos ? identifier_ref("") : curNamespace.substr(0, loc);
   }
-  return false;
 }
 
 }}
@@ -2,6 +2,7 @@
 
 #include <string>
 
+#include <common/CapricaConfig.h>
 #include <common/CapricaJobManager.h>
 #include <common/CaselessStringComparer.h>
 #include <common/FSUtils.h>
@@ -20,6 +21,7 @@ struct PapyrusCompilationNode final {
 
     PasCompile,
     PexDissassembly,
+    PexTransform,
 
     PasReflection,
     PexReflection,
@@ -44,10 +46,21 @@ struct PapyrusCompilationNode final {
         jobManager(mgr),
         type(compileType) {
     baseName = FSUtils::basenameAsRef(sourceFilePath);
+    // Files found in a directory are reported relative to it.
+    if (sourceFilePath.size() > reportedName.size()) {
+      auto baseLength = sourceFilePath.size() - reportedName.size();
+      if (sourceFilePath[baseLength - 1] == '\\' &&
+          sourceFilePath.compare(baseLength, reportedName.size(), reportedName) == 0) {
+        reportingContext.baseDirectory = sourceFilePath.substr(0, baseLength);
+      }
+    }
     // TODO: fix Imports hack
     if (type == NodeType::PapyrusImport)
       reportingContext.m_QuietWarnings = true;
-    jobManager->queueJob(&readJob);
+    // Files being compiled are always needed, but imports are
+    // otherwise only read when something awaits them.
+    if (conf::Performance::asyncFileRead || !isImport())
+      jobManager->queueJob(&readJob);
   }
 
   ~PapyrusCompilationNode() {
@@ -91,6 +104,10 @@ private:
   PapyrusResolutionContext* resolutionContext { nullptr };
   CapricaJobManager* jobManager;
 
+  bool isImport() const {
+    return type == NodeType::PapyrusImport || type == NodeType::PasReflection || type == NodeType::PexReflection;
+  }
+
   struct FileReadJob final : public BaseJob {
     using BaseJob::BaseJob;
     virtual void run() override;
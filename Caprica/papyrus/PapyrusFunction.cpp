@@ -1,7 +1,11 @@
 #include <papyrus/PapyrusFunction.h>
 
+#include <exception>
 #include <unordered_set>
 
+#include <common/CapricaJobManager.h>
+#include <common/CapricaMemoryReport.h>
+#include <common/CapricaTrace.h>
 #include <common/EngineLimits.h>
 
 #include <papyrus/PapyrusCFG.h>
@@ -19,11 +23,74 @@ bool PapyrusFunction::isDebugOnly() const {
   return userFlags.isDebugOnly || parentObject->isDebugOnly();
 }
 
+struct PapyrusFunction::BuildPexJob final : public CapricaJob {
+  explicit BuildPexJob(const PapyrusFunction* func,
+                       CapricaReportingContext& parentCtx,
+                       pex::PexFile* file,
+                       identifier_ref stateNm)
+      : function(func),
+        reportingContext(&parentCtx),
+        fragment(file->createFragment(reportingContext)),
+        stateName(stateNm) { }
+  BuildPexJob(const BuildPexJob&) = delete;
+  ~BuildPexJob() = default;
+
+  const PapyrusFunction* function;
+  CapricaReportingContext reportingContext;
+  pex::PexFile* fragment;
+  identifier_ref stateName;
+  pex::PexFunction* pexFunction { nullptr };
+  std::exception_ptr exception {};
+
+  virtual void run() override {
+    CapricaTrace::Scope trace { CapricaTrace::Category::Job, "BuildPex", function->name.to_string_view() };
+    CapricaMemoryReport::PhaseScope memoryPhase { CapricaMemoryReport::Phase::Compile };
+    // Exceptions can't escape a job, so they're passed on to buildPex.
+    try {
+      // The function only refers to its object and state by
+      // name, so they only need to exist in the fragment.
+      auto obj = fragment->alloc->make<pex::PexObject>();
+      obj->name = fragment->getString(function->parentObject->name);
+      auto state = fragment->alloc->make<pex::PexState>();
+      state->name = fragment->getString(stateName);
+      pexFunction = function->buildPexFunction(reportingContext, fragment, obj, state, pex::PexString());
+    } catch (...) {
+      exception = std::current_exception();
+    }
+  }
+};
+
 pex::PexFunction* PapyrusFunction::buildPex(CapricaReportingContext& repCtx,
                                             pex::PexFile* file,
                                             pex::PexObject* obj,
                                             pex::PexState* state,
                                             pex::PexString propName) const {
+  if (!buildPexJob)
+    return buildPexFunction(repCtx, file, obj, state, propName);
+  buildPexJob->await();
+  repCtx.takeDiagnostics(buildPexJob->reportingContext);
+  if (buildPexJob->exception)
+    std::rethrow_exception(buildPexJob->exception);
+  file->mergeFragment(buildPexJob->fragment, buildPexJob->pexFunction);
+  return buildPexJob->pexFunction;
+}
+
+void PapyrusFunction::queueBuildPex(CapricaReportingContext& repCtx,
+                                    CapricaJobManager* jobManager,
+                                    allocators::ChainedPool* jobAlloc,
+                                    pex::PexFile* file,
+                                    identifier_ref stateName) {
+  // Like the semantic job, this is in the script's allocator
+  // because the job manager may still refer to it after it has run.
+  buildPexJob = jobAlloc->make<BuildPexJob>(this, repCtx, file, stateName);
+  jobManager->queueJob(buildPexJob);
+}
+
+pex::PexFunction* PapyrusFunction::buildPexFunction(CapricaReportingContext& repCtx,
+                                                    pex::PexFile* file,
+                                                    pex::PexObject* obj,
+                                                    pex::PexState* state,
+                                                    pex::PexString propName) const {
   auto func = file->alloc->make<pex::PexFunction>();
   auto fDebInfo = file->alloc->make<pex::PexDebugFunctionInfo>();
   fDebInfo->objectName = obj->name;
@@ -66,7 +133,7 @@ pex::PexFunction* PapyrusFunction::buildPex(CapricaReportingContext& repCtx,
   bldr.populateFunction(func, fDebInfo);
 
   if (file->debugInfo)
-    file->debugInfo->functions.push_back(fDebInfo);
+    file->debugInfo->addFunction(fDebInfo);
 
   EngineLimits::checkLimit(repCtx,
                            location,
@@ -87,7 +154,47 @@ void PapyrusFunction::semantic(PapyrusResolutionContext* ctx) {
     p->semantic(ctx);
 }
 
+struct PapyrusFunction::Semantic2Job final : public CapricaJob {
+  explicit Semantic2Job(PapyrusFunction* func, PapyrusResolutionContext* parentCtx)
+      : function(func),
+        reportingContext(&parentCtx->reportingContext),
+        allocator(1024 * 4, MemoryOwner::ScriptAst, parentCtx->allocator->heapArena()),
+        resolutionContext(*parentCtx, reportingContext, &allocator) { }
+  Semantic2Job(const Semantic2Job&) = delete;
+  ~Semantic2Job() = default;
+
+  PapyrusFunction* function;
+  CapricaReportingContext reportingContext;
+  // Holds what the semantic pass adds to the function's tree, so it has to
+  // live as long as the script does, as this job does. Its heaps come from
+  // the script's arena, as the tree's nodes can only point within that.
+  allocators::ChainedPool allocator;
+  PapyrusResolutionContext resolutionContext;
+
+  virtual void run() override {
+    CapricaTrace::Scope trace { CapricaTrace::Category::Job, "Semantic2", function->name.to_string_view() };
+    CapricaMemoryReport::PhaseScope memoryPhase { CapricaMemoryReport::Phase::Compile };
+    function->checkBody(&resolutionContext);
+  }
+};
+
+void PapyrusFunction::queueSemantic2(PapyrusResolutionContext* ctx) {
+  // The job is in the script's allocator because the job
+  // manager may still refer to it after it has run.
+  semantic2Job = ctx->allocator->make<Semantic2Job>(this, ctx);
+  ctx->jobManager->queueJob(semantic2Job);
+}
+
 void PapyrusFunction::semantic2(PapyrusResolutionContext* ctx) {
+  if (!semantic2Job) {
+    checkBody(ctx);
+    return;
+  }
+  semantic2Job->await();
+  ctx->reportingContext.takeDiagnostics(semantic2Job->reportingContext);
+}
+
+void PapyrusFunction::checkBody(PapyrusResolutionContext* ctx) {
   if (isGlobal() && ctx->state && ctx->state->name != "")
     ctx->reportingContext.error(location, "Global functions are only allowed in the empty state.");
   if (isNative() && !ctx->object->isNative())
@@ -139,7 +246,8 @@ void PapyrusFunction::semantic2(PapyrusResolutionContext* ctx) {
     caseless_unordered_identifier_ref_set allLocalNames {};
     CheckLocalNamesStatementVisitor(PapyrusResolutionContext* oCtx) : ctx(oCtx) { }
 
-    virtual void visit(statements::PapyrusDeclareStatement* s) override {
+    using statements::PapyrusSelectiveStatementVisitor::visit;
+    void visit(statements::PapyrusDeclareStatement* s) {
       int i = 0;
       auto baseName = s->name;
       while (allLocalNames.count(s->name))
@@ -149,7 +257,7 @@ void PapyrusFunction::semantic2(PapyrusResolutionContext* ctx) {
   } visitor(ctx);
 
   for (auto s : statements)
-    s->visit(visitor);
+    statements::walkStatements(s, visitor);
 }
 
 bool PapyrusFunction::hasSameSignature(const PapyrusFunction* other) const {
@@ -3,6 +3,7 @@
 #include <string>
 #include <vector>
 
+#include <common/ArenaPtr.h>
 #include <common/CapricaFileLocation.h>
 #include <common/CaselessStringComparer.h>
 #include <common/identifier_ref.h>
@@ -39,7 +40,7 @@ struct PapyrusFunction final {
   PapyrusType returnType;
   PapyrusUserFlags userFlags {};
   IntrusiveLinkedList<PapyrusFunctionParameter> parameters {};
-  IntrusiveLinkedList<statements::PapyrusStatement> statements {};
+  ArenaSpan<statements::PapyrusStatement> statements {};
   PapyrusObject* parentObject { nullptr };
   PapyrusFunctionType functionType { PapyrusFunctionType::Unknown };
   identifier_ref remoteEventParent { "" };
@@ -61,13 +62,35 @@ struct PapyrusFunction final {
                              pex::PexObject* obj,
                              pex::PexState* state,
                              pex::PexString propName) const;
+  // Starts building the function on another thread, into a fragment of file.
+  // buildPex then waits for it, and merges the fragment into file.
+  void queueBuildPex(CapricaReportingContext& repCtx,
+                     CapricaJobManager* jobManager,
+                     allocators::ChainedPool* jobAlloc,
+                     pex::PexFile* file,
+                     identifier_ref stateName);
   void semantic(PapyrusResolutionContext* ctx);
+  // Starts checking the body of the function on another thread, with the
+  // names that ctx resolves at this point. semantic2 then waits for it.
+  void queueSemantic2(PapyrusResolutionContext* ctx);
   void semantic2(PapyrusResolutionContext* ctx);
 
   bool hasSameSignature(const PapyrusFunction* other) const;
   std::string prettySignature() const;
 
 private:
+  struct Semantic2Job;
+  Semantic2Job* semantic2Job { nullptr };
+  struct BuildPexJob;
+  BuildPexJob* buildPexJob { nullptr };
+
+  pex::PexFunction* buildPexFunction(CapricaReportingContext& repCtx,
+                                     pex::PexFile* file,
+                                     pex::PexObject* obj,
+                                     pex::PexState* state,
+                                     pex::PexString propName) const;
+  void checkBody(PapyrusResolutionContext* ctx);
+
   friend IntrusiveLinkedList<PapyrusFunction>;
   PapyrusFunction* next { nullptr };
 };
@@ -2,7 +2,6 @@
 
 #include <common/CapricaFileLocation.h>
 #include <common/identifier_ref.h>
-#include <common/IntrusiveLinkedList.h>
 
 #include <papyrus/PapyrusIdentifier.h>
 #include <papyrus/PapyrusResolutionContext.h>
@@ -34,10 +33,6 @@ struct PapyrusLockParameter final {
     guard = id.res.guard;
     // guard = const_cast<PapyrusGuard*>(id.res.guard);
   }
-
-private:
-  friend IntrusiveLinkedList<PapyrusLockParameter>;
-  PapyrusLockParameter* next { nullptr };
 };
 
 }}
@@ -25,6 +25,121 @@ const PapyrusObject* PapyrusObject::tryGetParentClass() const {
   return nullptr;
 }
 
+template <typename T>
+static T* tryFindMember(const caseless_unordered_identifier_ref_map<T*>& table, const identifier_ref& name) {
+  auto f = table.find(name);
+  if (f != table.end())
+    return f->second;
+  return nullptr;
+}
+
+// Adds the members of the parent to a table of the child's members. The
+// child's are added first, so they shadow the parent's of the same name.
+template <typename T>
+static void inheritMembers(caseless_unordered_identifier_ref_map<T*>& table,
+                           const caseless_unordered_identifier_ref_map<T*>& parentTable) {
+  table.reserve(table.size() + parentTable.size());
+  for (auto& m : parentTable)
+    table.emplace(m.first, m.second);
+}
+
+PapyrusProperty* PapyrusObject::tryFindProperty(const identifier_ref& name) const {
+  return tryFindMember(propertyTable, name);
+}
+
+PapyrusVariable* PapyrusObject::tryFindVariable(const identifier_ref& name) const {
+  return tryFindMember(variableTable, name);
+}
+
+PapyrusGuard* PapyrusObject::tryFindGuard(const identifier_ref& name) const {
+  return tryFindMember(guardTable, name);
+}
+
+PapyrusProperty* PapyrusObject::tryFindInheritedProperty(const identifier_ref& name) const {
+  return tryFindMember(inheritedPropertyTable, name);
+}
+
+PapyrusStruct* PapyrusObject::tryFindInheritedStruct(const identifier_ref& name) const {
+  return tryFindMember(inheritedStructTable, name);
+}
+
+PapyrusState* PapyrusObject::tryFindInheritedState(const identifier_ref& name) const {
+  return tryFindMember(inheritedStateTable, name);
+}
+
+PapyrusCustomEvent* PapyrusObject::tryFindInheritedCustomEvent(const identifier_ref& name) const {
+  return tryFindMember(inheritedCustomEventTable, name);
+}
+
+bool PapyrusObject::inheritsFrom(const PapyrusObject* ancestor) const {
+  if (this == ancestor)
+    return true;
+  if (resolutionState != PapyrusResoultionState::PreSemanticInProgress &&
+      resolutionState != PapyrusResoultionState::Unresolved)
+    return ancestorNames.count(ancestor->name) != 0;
+
+  // The tables aren't built yet, so walk the chain instead.
+  for (const PapyrusObject* obj = this; obj; obj = obj->tryGetParentClass()) {
+    if (obj == ancestor || idEq(obj->name, ancestor->name))
+      return true;
+  }
+  return false;
+}
+
+void PapyrusObject::buildMemberTables() {
+  // Duplicate names are reported by semantic2, and until then the first
+  // declaration is the one that's found, so nothing here overwrites.
+  for (auto pg : propertyGroups) {
+    for (auto p : pg->properties)
+      propertyTable.emplace(p->name, p);
+  }
+  for (auto v : variables)
+    variableTable.emplace(v->name, v);
+  for (auto g : guards)
+    guardTable.emplace(g->name, g);
+
+  inheritedPropertyTable = propertyTable;
+  for (auto s : structs)
+    inheritedStructTable.emplace(s->name, s);
+  for (auto s : states)
+    inheritedStateTable.emplace(s->name, s);
+  for (auto c : customEvents)
+    inheritedCustomEventTable.emplace(c->name, c);
+  ancestorNames.emplace(name);
+
+  // The parent finished preSemantic before resolving it as
+  // our parent class returned, so its tables are complete.
+  if (auto parent = tryGetParentClass()) {
+    inheritMembers(inheritedPropertyTable, parent->inheritedPropertyTable);
+    inheritMembers(inheritedStructTable, parent->inheritedStructTable);
+    inheritMembers(inheritedStateTable, parent->inheritedStateTable);
+    inheritMembers(inheritedCustomEventTable, parent->inheritedCustomEventTable);
+    ancestorNames.insert(parent->ancestorNames.begin(), parent->ancestorNames.end());
+  }
+}
+
+// Like checking the function bodies, building them
+// on other threads only pays off for large scripts.
+static constexpr size_t ParallelPexMinimumFunctionCount = 32;
+
+void PapyrusObject::queueFunctionPex(CapricaReportingContext& repCtx,
+                                     CapricaJobManager* jobManager,
+                                     allocators::ChainedPool* jobAlloc,
+                                     pex::PexFile* file) const {
+  size_t functionCount = 0;
+  for (auto s : states)
+    functionCount += s->functions.size();
+  if (functionCount < ParallelPexMinimumFunctionCount)
+    return;
+
+  for (auto s : states) {
+    for (auto f : s->functions) {
+      if (!f.second->isNative())
+        f.second->queueBuildPex(repCtx, jobManager, jobAlloc, file, s->name);
+    }
+  }
+}
+
 void PapyrusObject::buildPex(CapricaReportingContext& repCtx, pex::PexFile* file) const {
   auto obj = file->alloc->make<pex::PexObject>();
   obj->name = file->getString(name);
@@ -120,6 +235,7 @@ void PapyrusObject::semantic2(PapyrusResolutionContext* ctx) {
     v->semantic2(ctx);
   for (auto g : propertyGroups)
     g->semantic2(ctx);
+  queueFunctionBodies(ctx);
   for (auto s : states)
     s->semantic2(ctx);
   for (auto c : customEvents)
@@ -148,6 +264,33 @@ void PapyrusObject::semantic2(PapyrusResolutionContext* ctx) {
   resolutionState = PapyrusResoultionState::Semantic2Completed;
 }
 
+// Below this, checking the function bodies on other threads
+// costs more than it saves.
+static constexpr size_t ParallelSemanticMinimumFunctionCount = 32;
+
+void PapyrusObject::queueFunctionBodies(PapyrusResolutionContext* ctx) {
+  // A large script would otherwise be checked on a single thread long after
+  // every other script is done, so its function bodies are checked as jobs
+  // of their own. The states still report their diagnostics in order, as
+  // semantic2 waits for each function's job in turn.
+  if (!ctx->jobManager)
+    return;
+  size_t functionCount = 0;
+  for (auto s : states)
+    functionCount += s->functions.size();
+  if (functionCount < ParallelSemanticMinimumFunctionCount)
+    return;
+
+  for (auto s : states) {
+    ctx->state = s;
+    for (auto f : s->functions) {
+      if (!f.second->isNative())
+        f.second->queueSemantic2(ctx);
+    }
+  }
+  ctx->state = nullptr;
+}
+
 void PapyrusObject::checkForInheritedIdentifierConflicts(
     CapricaReportingContext& repCtx,
     caseless_unordered_identifier_ref_map<std::pair<bool, const char*>>& identMap,
@@ -90,6 +90,25 @@ struct PapyrusObject final {
   }
 
   const PapyrusObject* tryGetParentClass() const;
+
+  // These only search the members declared on this object.
+  PapyrusProperty* tryFindProperty(const identifier_ref& name) const;
+  PapyrusVariable* tryFindVariable(const identifier_ref& name) const;
+  PapyrusGuard* tryFindGuard(const identifier_ref& name) const;
+  // These also search the parent classes, and return the closest declaration.
+  PapyrusProperty* tryFindInheritedProperty(const identifier_ref& name) const;
+  PapyrusStruct* tryFindInheritedStruct(const identifier_ref& name) const;
+  PapyrusState* tryFindInheritedState(const identifier_ref& name) const;
+  PapyrusCustomEvent* tryFindInheritedCustomEvent(const identifier_ref& name) const;
+  // Whether this is `ancestor`, or extends it, directly or not.
+  bool inheritsFrom(const PapyrusObject* ancestor) const;
+
+  // Starts building the functions of a large script on other threads,
+  // with their jobs in jobAlloc. buildPex then merges them in order.
+  void queueFunctionPex(CapricaReportingContext& repCtx,
+                        CapricaJobManager* jobManager,
+                        allocators::ChainedPool* jobAlloc,
+                        pex::PexFile* file) const;
   void buildPex(CapricaReportingContext& repCtx, pex::PexFile* file) const;
   void semantic(PapyrusResolutionContext* ctx);
   void semantic2(PapyrusResolutionContext* ctx);
@@ -97,6 +116,7 @@ struct PapyrusObject final {
   void preSemantic(PapyrusResolutionContext* ctx) {
     resolutionState = PapyrusResoultionState::PreSemanticInProgress;
     parentClass = ctx->resolveType(parentClass, true);
+    buildMemberTables();
     resolutionState = PapyrusResoultionState::PreSemanticCompleted;
   }
 
@@ -113,6 +133,23 @@ private:
   PapyrusPropertyGroup* rootPropertyGroup { nullptr };
   std::string lowerName {};
 
+  // The members by name, so that resolving a name is a single lookup rather
+  // than a walk over every member of every parent class. They're built at the
+  // end of preSemantic, once the parent class is known, and never change after
+  // that, so other nodes can read them without locking.
+  caseless_unordered_identifier_ref_map<PapyrusProperty*> propertyTable {};
+  caseless_unordered_identifier_ref_map<PapyrusVariable*> variableTable {};
+  caseless_unordered_identifier_ref_map<PapyrusGuard*> guardTable {};
+  caseless_unordered_identifier_ref_map<PapyrusProperty*> inheritedPropertyTable {};
+  caseless_unordered_identifier_ref_map<PapyrusStruct*> inheritedStructTable {};
+  caseless_unordered_identifier_ref_map<PapyrusState*> inheritedStateTable {};
+  caseless_unordered_identifier_ref_map<PapyrusCustomEvent*> inheritedCustomEventTable {};
+  // The names of this object and all of its parent classes.
+  caseless_unordered_identifier_ref_set ancestorNames {};
+
+  void buildMemberTables();
+  void queueFunctionBodies(PapyrusResolutionContext* ctx);
+
   void
   checkForInheritedIdentifierConflicts(CapricaReportingContext& repCtx,
                                        caseless_unordered_identifier_ref_map<std::pair<bool, const char*>>& identMap,
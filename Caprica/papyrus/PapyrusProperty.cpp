@@ -34,7 +34,7 @@ void PapyrusProperty::buildPex(CapricaReportingContext& repCtx, pex::PexFile* fi
       if (line > std::numeric_limits<uint16_t>::max())
         repCtx.fatal(location, "The file has too many lines for the debug info to be able to map correctly!");
       fDebInfo->instructionLineMap.push_back((uint16_t)line);
-      file->debugInfo->functions.push_back(fDebInfo);
+      file->debugInfo->addFunction(fDebInfo);
     }
   } else if (isAuto()) {
     prop->isAuto = true;
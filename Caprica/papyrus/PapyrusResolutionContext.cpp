@@ -40,13 +40,7 @@ void PapyrusResolutionContext::addImport(const CapricaFileLocation& location, co
 }
 
 bool PapyrusResolutionContext::isObjectSomeParentOf(const PapyrusObject* child, const PapyrusObject* parent) {
-  if (child == parent)
-    return true;
-  if (idEq(child->name, parent->name))
-    return true;
-  if (auto parentObject = child->tryGetParentClass())
-    return isObjectSomeParentOf(parentObject, parent);
-  return false;
+  return child->inheritsFrom(parent);
 }
 
 bool PapyrusResolutionContext::canExplicitlyCast(CapricaFileLocation loc,
@@ -270,52 +264,25 @@ const PapyrusFunction* PapyrusResolutionContext::tryResolveEvent(const PapyrusOb
 
 const PapyrusCustomEvent* PapyrusResolutionContext::tryResolveCustomEvent(const PapyrusObject* parentObj,
                                                                           const identifier_ref& name) const {
-  for (auto c : parentObj->customEvents)
-    if (idEq(c->name, name))
-      return c;
-
-  if (auto parentClass = parentObj->tryGetParentClass())
-    return tryResolveCustomEvent(parentClass, name);
-
-  return nullptr;
+  return parentObj->tryFindInheritedCustomEvent(name);
 }
 
 const PapyrusState* PapyrusResolutionContext::tryResolveState(const identifier_ref& name,
                                                               const PapyrusObject* parentObj) const {
   if (!parentObj)
     parentObj = object;
-
-  for (auto s : parentObj->states)
-    if (idEq(s->name, name))
-      return s;
-
-  if (auto parentClass = parentObj->tryGetParentClass())
-    return tryResolveState(name, parentClass);
-
-  return nullptr;
+  return parentObj->tryFindInheritedState(name);
 }
 
 const PapyrusGuard* PapyrusResolutionContext::tryResolveGuard(const PapyrusObject* parentObject,
                                                               const identifier_ref& guardName) {
   // TODO: Starfield: Verify that guards are not inherited and limited to the current parentObject.
-  for (auto& s : parentObject->guards)
-    if (idEq(s->name, guardName))
-      return s;
-  return nullptr;
+  return parentObject->tryFindGuard(guardName);
 }
 
 static bool tryResolveStruct(const PapyrusObject* object, const identifier_ref& structName, const PapyrusStruct** ret) {
-  for (auto& s : object->structs) {
-    if (idEq(s->name, structName)) {
-      *ret = s;
-      return true;
-    }
-  }
-
-  if (auto parentClass = object->tryGetParentClass())
-    return tryResolveStruct(parentClass, structName, ret);
-
-  return false;
+  *ret = object->tryFindInheritedStruct(structName);
+  return *ret != nullptr;
 }
 
 PapyrusType PapyrusResolutionContext::resolveType(PapyrusType tp, bool lazy) {
@@ -434,11 +401,8 @@ PapyrusIdentifier PapyrusResolutionContext::tryResolveIdentifier(const PapyrusId
 
     // Parameters are allowed to have the same name as properties, and properties override them
     if (!function->isGlobal()) {
-      for (auto pg : object->propertyGroups) {
-        for (auto p : pg->properties)
-          if (idEq(p->name, ident.res.name))
-            resolvedIds.push_back(PapyrusIdentifier::Property(ident.location, p));
-      }
+      if (auto p = object->tryFindProperty(ident.res.name))
+        resolvedIds.push_back(PapyrusIdentifier::Property(ident.location, p));
     }
 
     for (auto p : function->parameters)
@@ -447,13 +411,11 @@ PapyrusIdentifier PapyrusResolutionContext::tryResolveIdentifier(const PapyrusId
   }
 
   if (!function || !function->isGlobal()) {
-    for (auto v : object->variables)
-      if (idEq(v->name, ident.res.name))
-        resolvedIds.push_back(PapyrusIdentifier::Variable(ident.location, v));
+    if (auto v = object->tryFindVariable(ident.res.name))
+      resolvedIds.push_back(PapyrusIdentifier::Variable(ident.location, v));
 
-    for (auto g : object->guards)
-      if (idEq(g->name, ident.res.name))
-        resolvedIds.push_back(PapyrusIdentifier::Guard(ident.location, g));
+    if (auto g = object->tryFindGuard(ident.res.name))
+      resolvedIds.push_back(PapyrusIdentifier::Guard(ident.location, g));
   }
   // locals get resolved dead last
   // This handles local var resolution.
@@ -595,15 +557,13 @@ PapyrusIdentifier PapyrusResolutionContext::tryResolveMemberIdentifier(const Pap
       if (idEq(sm->name, ident.res.name))
         return PapyrusIdentifier::StructMember(ident.location, sm);
   } else if (baseType.type == PapyrusType::Kind::ResolvedObject) {
-    for (auto& propGroup : baseType.resolved.obj->awaitSemantic()->propertyGroups) {
-      for (auto& prop : propGroup->properties)
-        if (idEq(prop->name, ident.res.name))
-          return PapyrusIdentifier::Property(ident.location, prop);
-    }
     // TODO: Starfield: Verify that child classes cannot use guards inherited from parent classes.
-
-    if (auto parentClass = baseType.resolved.obj->tryGetParentClass())
-      return tryResolveMemberIdentifier(baseType.resolved.obj->parentClass, ident);
+    if (auto prop = baseType.resolved.obj->awaitSemantic()->tryFindInheritedProperty(ident.res.name)) {
+      // The property's type is resolved by the semantic pass of the class that declares it.
+      if (prop->parent != baseType.resolved.obj)
+        prop->parent->awaitSemantic();
+      return PapyrusIdentifier::Property(ident.location, prop);
+    }
   }
 
   return ident;
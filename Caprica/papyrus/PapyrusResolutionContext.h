@@ -6,6 +6,7 @@
 
 #include <common/allocators/ChainedPool.h>
 #include <common/CapricaFileLocation.h>
+#include <common/CapricaJobManager.h>
 #include <common/CaselessStringComparer.h>
 #include <common/identifier_ref.h>
 #include <common/IntrusiveLinkedList.h>
@@ -45,6 +46,8 @@ struct PapyrusResolutionContext final {
   // If true, we're resolving a tree generated from
   // a pex file.
   bool isPexResolution { false };
+  // If set, the function bodies of large scripts are checked as separate jobs.
+  CapricaJobManager* jobManager { nullptr };
 
   void addImport(const CapricaFileLocation& location, const identifier_ref& import);
   void clearImports() { importedNodes.clear(); }
@@ -123,6 +126,18 @@ struct PapyrusResolutionContext final {
   }
 
   explicit PapyrusResolutionContext(CapricaReportingContext& repCtx) : reportingContext(repCtx) { }
+  // A context for checking a function body on another thread. It resolves names
+  // the same way parentCtx does at this point, but keeps its own local state.
+  explicit PapyrusResolutionContext(const PapyrusResolutionContext& parentCtx,
+                                    CapricaReportingContext& repCtx,
+                                    allocators::ChainedPool* alloc)
+      : reportingContext(repCtx),
+        allocator(alloc),
+        script(parentCtx.script),
+        object(parentCtx.object),
+        state(parentCtx.state),
+        isPexResolution(parentCtx.isPexResolution),
+        importedNodes(parentCtx.importedNodes) { }
   PapyrusResolutionContext(const PapyrusResolutionContext&) = delete;
   ~PapyrusResolutionContext() = default;
 
@@ -8,16 +8,27 @@
 
 namespace caprica { namespace papyrus {
 
-pex::PexFile* PapyrusScript::buildPex(CapricaReportingContext& repCtx) const {
-  auto alloc = new allocators::ChainedPool(1024 * 4);
+pex::PexFile* PapyrusScript::buildPex(CapricaReportingContext& repCtx, CapricaJobManager* jobManager) const {
+  auto alloc = new allocators::ChainedPool(1024 * 4, MemoryOwner::PexFile);
   auto pex = alloc->make<pex::PexFile>(alloc);
+  pex->reportingContext = &repCtx;
   pex->setGameAndVersion(conf::Papyrus::game);
   if (conf::CodeGeneration::emitDebugInfo) {
     pex->debugInfo = alloc->make<pex::PexDebugInfo>();
     pex->debugInfo->modificationTime = lastModificationTime;
   }
   pex->compilationTime = time(nullptr);
-  pex->sourceFileName = pex->alloc->allocateString(sourceFileName);
+  if (conf::CodeGeneration::reproducible) {
+    if (pex->debugInfo)
+      pex->debugInfo->modificationTime = conf::CodeGeneration::reproducibleTimestamp;
+    pex->compilationTime = conf::CodeGeneration::reproducibleTimestamp;
+  }
+  // The full path depends on where the sources were checked out, so reproducible
+  // builds use the path relative to the input or import directory instead.
+  if (conf::CodeGeneration::reproducible)
+    pex->sourceFileName = pex->alloc->allocateString(repCtx.filename);
+  else
+    pex->sourceFileName = pex->alloc->allocateString(sourceFileName);
 
   static std::string computerName = []() -> std::string {
     char compNameBuf[MAX_COMPUTERNAME_LENGTH + 1];
@@ -26,7 +37,8 @@ pex::PexFile* PapyrusScript::buildPex(CapricaReportingContext& repCtx) const {
       CapricaReportingContext::logicalFatal("Failed to get the computer name!");
     return std::string(compNameBuf, compNameBufLength);
   }();
-  pex->computerName = computerName;
+  if (!conf::CodeGeneration::stripUserInfo)
+    pex->computerName = computerName;
 
   static std::string userName = []() -> std::string {
     char userNameBuf[UNLEN + 1];
@@ -37,8 +49,13 @@ pex::PexFile* PapyrusScript::buildPex(CapricaReportingContext& repCtx) const {
       userNameBufLength--;
     return std::string(userNameBuf, userNameBufLength);
   }();
-  pex->userName = userName;
+  if (!conf::CodeGeneration::stripUserInfo)
+    pex->userName = userName;
 
+  if (jobManager) {
+    for (auto o : objects)
+      o->queueFunctionPex(repCtx, jobManager, allocator, pex);
+  }
   for (auto o : objects)
     o->buildPex(repCtx, pex);
 
@@ -27,7 +27,8 @@ struct PapyrusScript final {
   PapyrusScript(const PapyrusScript&) = delete;
   ~PapyrusScript() = default;
 
-  pex::PexFile* buildPex(CapricaReportingContext& repCtx) const;
+  // With a job manager, the functions of large scripts are built in parallel.
+  pex::PexFile* buildPex(CapricaReportingContext& repCtx, CapricaJobManager* jobManager = nullptr) const;
 
   void preSemantic(PapyrusResolutionContext* ctx) {
     ctx->script = this;
@@ -1,21 +1,17 @@
 #include <papyrus/PapyrusUserFlags.h>
 
+#include <bit>
+
 namespace caprica { namespace papyrus {
 
 pex::PexUserFlags PapyrusUserFlags::buildPex(pex::PexFile* file,
                                              CapricaUserFlagsDefinition::ValidLocations limitLocations) const {
   pex::PexUserFlags pexFlags;
-  size_t f = 1;
-  for (uint8_t i = 0; i < sizeof(size_t) * 8; i++) {
-    if ((data & f) == f) {
-      auto uf = conf::Papyrus::userFlagsDefinition.getFlag(i);
-      if ((uf.validLocations & limitLocations) != CapricaUserFlagsDefinition::ValidLocations::None) {
-        auto lowerName = uf.name;
-        identifierToLower(lowerName);
-        pexFlags |= file->getUserFlag(file->getString(lowerName), uf.bitIndex);
-      }
-    }
-    f <<= 1;
+  // Only visit the bits that are set, clearing the lowest one each time.
+  for (auto bits = data; bits != 0; bits &= bits - 1) {
+    auto& uf = conf::Papyrus::userFlagsDefinition.getFlag(std::countr_zero(bits));
+    if ((uf.validLocations & limitLocations) != CapricaUserFlagsDefinition::ValidLocations::None)
+      pexFlags |= file->getUserFlag(file->getString(uf.lowerName), uf.bitIndex);
   }
   return pexFlags;
 }
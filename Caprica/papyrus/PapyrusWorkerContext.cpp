@@ -0,0 +1,10 @@
+#include <papyrus/PapyrusWorkerContext.h>
+
+namespace caprica { namespace papyrus {
+
+PapyrusWorkerContext& PapyrusWorkerContext::current() {
+  static thread_local PapyrusWorkerContext ctx {};
+  return ctx;
+}
+
+}}
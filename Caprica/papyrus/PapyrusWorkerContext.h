@@ -0,0 +1,29 @@
+#pragma once
+
+#include <common/allocators/CachePool.h>
+#include <common/allocators/ReffyStringPool.h>
+
+#include <pex/FixedPexStringMap.h>
+#include <pex/PexFunctionBuilder.h>
+#include <pex/PexWriter.h>
+
+namespace caprica { namespace papyrus {
+
+// The large per-file structures used while compiling a script, kept
+// around per worker thread and reset between files, so that their setup
+// cost is paid once per thread rather than once per script.
+// Anything acquired here may be released on a different thread, in
+// which case it simply moves to that thread's context.
+struct PapyrusWorkerContext final {
+  allocators::CachePool<allocators::ReffyStringPool> stringTables {};
+  allocators::CachePool<pex::FixedPexStringMap<pex::detail::TempVarDescriptor>> tempVarMaps {};
+  allocators::CachePool<pex::PexWriter> pexWriters {};
+
+  PapyrusWorkerContext() = default;
+  PapyrusWorkerContext(const PapyrusWorkerContext&) = delete;
+  ~PapyrusWorkerContext() = default;
+
+  static PapyrusWorkerContext& current();
+};
+
+}}
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <common/ArenaPtr.h>
+
 #include <papyrus/expressions/PapyrusExpression.h>
 #include <papyrus/PapyrusObject.h>
 #include <papyrus/PapyrusType.h>
@@ -11,14 +13,13 @@
 namespace caprica { namespace papyrus { namespace expressions {
 
 struct PapyrusArrayIndexExpression final : public PapyrusExpression {
-  PapyrusExpression* baseExpression { nullptr };
-  PapyrusExpression* indexExpression { nullptr };
+  ArenaPtr<PapyrusExpression> baseExpression {};
+  ArenaPtr<PapyrusExpression> indexExpression {};
 
-  explicit PapyrusArrayIndexExpression(CapricaFileLocation loc) : PapyrusExpression(loc) { }
+  explicit PapyrusArrayIndexExpression(CapricaFileLocation loc) : PapyrusExpression(loc, PapyrusExpressionKind::ArrayIndex) { }
   PapyrusArrayIndexExpression(const PapyrusArrayIndexExpression&) = delete;
-  virtual ~PapyrusArrayIndexExpression() override = default;
 
-  virtual pex::PexValue generateLoad(pex::PexFile* file, pex::PexFunctionBuilder& bldr) const override {
+  pex::PexValue generateLoad(pex::PexFile* file, pex::PexFunctionBuilder& bldr) const {
     namespace op = caprica::pex::op;
     auto base = baseExpression->generateLoad(file, bldr);
     auto idx = indexExpression->generateLoad(file, bldr);
@@ -36,7 +37,7 @@ struct PapyrusArrayIndexExpression final : public PapyrusExpression {
     bldr << op::arraysetelement { pex::PexValue::Identifier::fromVar(base), idx, val };
   }
 
-  virtual void semantic(PapyrusResolutionContext* ctx) override {
+  void semantic(PapyrusResolutionContext* ctx) {
     baseExpression->semantic(ctx);
     ctx->checkForPoison(baseExpression);
     if (baseExpression->resultType().type != PapyrusType::Kind::Array) {
@@ -49,14 +50,12 @@ struct PapyrusArrayIndexExpression final : public PapyrusExpression {
     indexExpression = ctx->coerceExpression(indexExpression, PapyrusType::Int(indexExpression->location));
   }
 
-  virtual PapyrusType resultType() const override {
+  PapyrusType resultType() const {
     auto res = baseExpression->resultType();
     if (res.type == PapyrusType::Kind::Array)
       return res.getElementType();
     return PapyrusType::None(location);
   }
-
-  virtual PapyrusArrayIndexExpression* asArrayIndexExpression() override { return this; }
 };
 
 }}}
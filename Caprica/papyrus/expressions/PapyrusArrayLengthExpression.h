@@ -10,21 +10,18 @@
 namespace caprica { namespace papyrus { namespace expressions {
 
 struct PapyrusArrayLengthExpression final : public PapyrusExpression {
-  explicit PapyrusArrayLengthExpression(const CapricaFileLocation& loc) : PapyrusExpression(loc) { }
+  explicit PapyrusArrayLengthExpression(const CapricaFileLocation& loc) : PapyrusExpression(loc, PapyrusExpressionKind::ArrayLength) { }
   PapyrusArrayLengthExpression(const PapyrusArrayLengthExpression&) = delete;
-  virtual ~PapyrusArrayLengthExpression() override = default;
 
-  virtual pex::PexValue generateLoad(pex::PexFile*, pex::PexFunctionBuilder&) const override {
+  pex::PexValue generateLoad(pex::PexFile*, pex::PexFunctionBuilder&) const {
     CapricaReportingContext::logicalFatal("This shouldn't be called!");
   }
 
-  virtual void semantic(PapyrusResolutionContext* ctx) override {
+  void semantic(PapyrusResolutionContext* ctx) {
     ctx->reportingContext.fatal(location, "Illegal identifier: 'Length'!");
   }
 
-  virtual PapyrusType resultType() const override { return PapyrusType::Int(location); }
-
-  virtual PapyrusArrayLengthExpression* asArrayLengthExpression() override { return this; }
+  PapyrusType resultType() const { return PapyrusType::Int(location); }
 };
 
 }}}
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <common/ArenaPtr.h>
+
 #include <papyrus/expressions/PapyrusExpression.h>
 
 #include <pex/PexFile.h>
@@ -30,15 +32,14 @@ enum class PapyrusBinaryOperatorType {
 };
 
 struct PapyrusBinaryOpExpression final : public PapyrusExpression {
-  PapyrusExpression* left { nullptr };
+  ArenaPtr<PapyrusExpression> left {};
   PapyrusBinaryOperatorType operation { PapyrusBinaryOperatorType::None };
-  PapyrusExpression* right { nullptr };
+  ArenaPtr<PapyrusExpression> right {};
 
-  explicit PapyrusBinaryOpExpression(const CapricaFileLocation& loc) : PapyrusExpression(loc) { }
+  explicit PapyrusBinaryOpExpression(const CapricaFileLocation& loc) : PapyrusExpression(loc, PapyrusExpressionKind::BinaryOp) { }
   PapyrusBinaryOpExpression(const PapyrusBinaryOpExpression&) = delete;
-  virtual ~PapyrusBinaryOpExpression() override = default;
 
-  virtual pex::PexValue generateLoad(pex::PexFile* file, pex::PexFunctionBuilder& bldr) const override {
+  pex::PexValue generateLoad(pex::PexFile* file, pex::PexFunctionBuilder& bldr) const {
     namespace op = caprica::pex::op;
     auto lVal = left->generateLoad(file, bldr);
     auto dest = bldr.allocTemp(this->resultType());
@@ -140,7 +141,7 @@ struct PapyrusBinaryOpExpression final : public PapyrusExpression {
     return dest;
   }
 
-  virtual void semantic(PapyrusResolutionContext* ctx) override {
+  void semantic(PapyrusResolutionContext* ctx) {
     assert(operation != PapyrusBinaryOperatorType::None);
     left->semantic(ctx);
     ctx->checkForPoison(left);
@@ -186,7 +187,7 @@ struct PapyrusBinaryOpExpression final : public PapyrusExpression {
     CapricaReportingContext::logicalFatal("Unknown PapyrusBinaryOperatorType in semantic pass!");
   }
 
-  virtual PapyrusType resultType() const override {
+  PapyrusType resultType() const {
     // This is dependent on the operator.
     switch (operation) {
       case PapyrusBinaryOperatorType::BooleanOr:
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <common/ArenaPtr.h>
+
 #include <papyrus/expressions/PapyrusExpression.h>
 #include <papyrus/PapyrusType.h>
 
@@ -10,20 +12,18 @@
 namespace caprica { namespace papyrus { namespace expressions {
 
 struct PapyrusCastExpression final : public PapyrusExpression {
-  PapyrusExpression* innerExpression { nullptr };
+  ArenaPtr<PapyrusExpression> innerExpression {};
   PapyrusType targetType;
 
   explicit PapyrusCastExpression(CapricaFileLocation loc, const PapyrusType& targ)
-      : PapyrusExpression(loc), targetType(targ) { }
+      : PapyrusExpression(loc, PapyrusExpressionKind::Cast), targetType(targ) { }
   explicit PapyrusCastExpression(CapricaFileLocation loc, PapyrusType&& targ)
-      : PapyrusExpression(loc), targetType(std::move(targ)) { }
+      : PapyrusExpression(loc, PapyrusExpressionKind::Cast), targetType(std::move(targ)) { }
   PapyrusCastExpression(const PapyrusCastExpression&) = delete;
-  virtual ~PapyrusCastExpression() override = default;
 
-  virtual pex::PexValue generateLoad(pex::PexFile* file, pex::PexFunctionBuilder& bldr) const override;
-  virtual void semantic(PapyrusResolutionContext* ctx) override;
-  virtual PapyrusType resultType() const override;
-  virtual PapyrusCastExpression* asCastExpression() override { return this; }
+  pex::PexValue generateLoad(pex::PexFile* file, pex::PexFunctionBuilder& bldr) const;
+  void semantic(PapyrusResolutionContext* ctx);
+  PapyrusType resultType() const;
 };
 
 }}}
@@ -0,0 +1,35 @@
+#include <papyrus/expressions/PapyrusExpression.h>
+
+#include <papyrus/expressions/PapyrusExpressionVisitor.h>
+
+namespace caprica { namespace papyrus { namespace expressions {
+
+pex::PexValue PapyrusExpression::generateLoad(pex::PexFile* file, pex::PexFunctionBuilder& bldr) const {
+  return visitExpression(this, [&](auto expr) { return expr->generateLoad(file, bldr); });
+}
+
+void PapyrusExpression::semantic(PapyrusResolutionContext* ctx) {
+  visitExpression(this, [&](auto expr) { expr->semantic(ctx); });
+}
+
+PapyrusType PapyrusExpression::resultType() const {
+  return visitExpression(this, [](auto expr) { return expr->resultType(); });
+}
+
+#define DEFINE_AS_EXPRESSION(name)                                                                                     \
+  Papyrus##name##Expression* PapyrusExpression::as##name##Expression() {                                               \
+    if (kind == PapyrusExpressionKind::name)                                                                           \
+      return static_cast<Papyrus##name##Expression*>(this);                                                            \
+    return nullptr;                                                                                                    \
+  }
+DEFINE_AS_EXPRESSION(ArrayLength)
+DEFINE_AS_EXPRESSION(ArrayIndex)
+DEFINE_AS_EXPRESSION(FunctionCall)
+DEFINE_AS_EXPRESSION(Identifier)
+DEFINE_AS_EXPRESSION(Literal)
+DEFINE_AS_EXPRESSION(MemberAccess)
+DEFINE_AS_EXPRESSION(Parent)
+DEFINE_AS_EXPRESSION(Cast)
+#undef DEFINE_AS_EXPRESSION
+
+}}}
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <cstdint>
+
 #include <common/CapricaFileLocation.h>
 #include <papyrus/PapyrusResolutionContext.h>
 #include <papyrus/PapyrusType.h>
@@ -19,27 +21,49 @@ struct PapyrusMemberAccessExpression;
 struct PapyrusParentExpression;
 struct PapyrusCastExpression;
 
-struct PapyrusExpression abstract {
+enum class PapyrusExpressionKind : uint8_t {
+  ArrayIndex,
+  ArrayLength,
+  BinaryOp,
+  Cast,
+  FunctionCall,
+  Identifier,
+  Is,
+  Literal,
+  MemberAccess,
+  NewArray,
+  NewStruct,
+  Parent,
+  Self,
+  UnaryOp,
+};
+
+// Expressions are dispatched on their kind tag rather than through a vtable.
+// This keeps the nodes free of a vptr and lets the compiler see the full set of
+// targets at each call site; see PapyrusExpressionVisitor.h. The tag shares a
+// word with the 32-bit location, so the base of every node is only 8 bytes.
+struct PapyrusExpression {
   const CapricaFileLocation location;
+  const PapyrusExpressionKind kind;
 
-  explicit PapyrusExpression(CapricaFileLocation loc) : location(loc) { }
+  explicit PapyrusExpression(CapricaFileLocation loc, PapyrusExpressionKind k) : location(loc), kind(k) { }
   PapyrusExpression(const PapyrusExpression&) = delete;
-  virtual ~PapyrusExpression() = default;
+  ~PapyrusExpression() = default;
 
-  virtual pex::PexValue generateLoad(pex::PexFile* file, pex::PexFunctionBuilder& bldr) const = 0;
-  virtual void semantic(PapyrusResolutionContext* ctx) = 0;
-  virtual PapyrusType resultType() const = 0;
+  pex::PexValue generateLoad(pex::PexFile* file, pex::PexFunctionBuilder& bldr) const;
+  void semantic(PapyrusResolutionContext* ctx);
+  PapyrusType resultType() const;
 
-  // These exist because dynamic_cast is slow.
   // This list only contains expressions that we actually check for.
-  virtual PapyrusArrayLengthExpression* asArrayLengthExpression() { return nullptr; }
-  virtual PapyrusArrayIndexExpression* asArrayIndexExpression() { return nullptr; }
-  virtual PapyrusFunctionCallExpression* asFunctionCallExpression() { return nullptr; }
-  virtual PapyrusIdentifierExpression* asIdentifierExpression() { return nullptr; }
-  virtual PapyrusLiteralExpression* asLiteralExpression() { return nullptr; }
-  virtual PapyrusMemberAccessExpression* asMemberAccessExpression() { return nullptr; }
-  virtual PapyrusParentExpression* asParentExpression() { return nullptr; }
-  virtual PapyrusCastExpression* asCastExpression() { return nullptr; }
+  PapyrusArrayLengthExpression* asArrayLengthExpression();
+  PapyrusArrayIndexExpression* asArrayIndexExpression();
+  PapyrusFunctionCallExpression* asFunctionCallExpression();
+  PapyrusIdentifierExpression* asIdentifierExpression();
+  PapyrusLiteralExpression* asLiteralExpression();
+  PapyrusMemberAccessExpression* asMemberAccessExpression();
+  PapyrusParentExpression* asParentExpression();
+  PapyrusCastExpression* asCastExpression();
 };
+static_assert(sizeof(PapyrusExpression) == 8, "The kind should share a word with the location");
 
 }}}
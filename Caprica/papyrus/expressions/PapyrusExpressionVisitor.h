@@ -0,0 +1,53 @@
+#pragma once
+
+#include <type_traits>
+
+#include <common/CapricaReportingContext.h>
+
+#include <papyrus/expressions/PapyrusArrayIndexExpression.h>
+#include <papyrus/expressions/PapyrusArrayLengthExpression.h>
+#include <papyrus/expressions/PapyrusBinaryOpExpression.h>
+#include <papyrus/expressions/PapyrusCastExpression.h>
+#include <papyrus/expressions/PapyrusExpression.h>
+#include <papyrus/expressions/PapyrusFunctionCallExpression.h>
+#include <papyrus/expressions/PapyrusIdentifierExpression.h>
+#include <papyrus/expressions/PapyrusIsExpression.h>
+#include <papyrus/expressions/PapyrusLiteralExpression.h>
+#include <papyrus/expressions/PapyrusMemberAccessExpression.h>
+#include <papyrus/expressions/PapyrusNewArrayExpression.h>
+#include <papyrus/expressions/PapyrusNewStructExpression.h>
+#include <papyrus/expressions/PapyrusParentExpression.h>
+#include <papyrus/expressions/PapyrusSelfExpression.h>
+#include <papyrus/expressions/PapyrusUnaryOpExpression.h>
+
+namespace caprica { namespace papyrus { namespace expressions {
+
+// Calls `visitor` with `expr` downcast to its concrete type.
+template <typename Expr, typename Visitor>
+ALWAYS_INLINE decltype(auto) visitExpression(Expr* expr, Visitor&& visitor) {
+#define VISIT_KIND(name)                                                                                               \
+  case PapyrusExpressionKind::name:                                                                                    \
+    return visitor(static_cast<std::conditional_t<std::is_const_v<Expr>,                                               \
+                                                  const Papyrus##name##Expression*,                                    \
+                                                  Papyrus##name##Expression*>>(expr));
+  switch (expr->kind) {
+    VISIT_KIND(ArrayIndex)
+    VISIT_KIND(ArrayLength)
+    VISIT_KIND(BinaryOp)
+    VISIT_KIND(Cast)
+    VISIT_KIND(FunctionCall)
+    VISIT_KIND(Identifier)
+    VISIT_KIND(Is)
+    VISIT_KIND(Literal)
+    VISIT_KIND(MemberAccess)
+    VISIT_KIND(NewArray)
+    VISIT_KIND(NewStruct)
+    VISIT_KIND(Parent)
+    VISIT_KIND(Self)
+    VISIT_KIND(UnaryOp)
+  }
+#undef VISIT_KIND
+  CapricaReportingContext::logicalFatal("Unknown PapyrusExpressionKind!");
+}
+
+}}}
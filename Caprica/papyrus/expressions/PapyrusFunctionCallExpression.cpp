@@ -1,6 +1,7 @@
 #include <papyrus/expressions/PapyrusFunctionCallExpression.h>
 
 #include <cstring>
+#include <vector>
 
 #include <papyrus/expressions/PapyrusLiteralExpression.h>
 #include <papyrus/expressions/PapyrusParentExpression.h>
@@ -21,11 +22,8 @@ pex::PexValue PapyrusFunctionCallExpression::generateLoad(pex::PexFile* file,
   if (function.type == PapyrusIdentifierType::BuiltinArrayFunction) {
     assert(arguments.size() <= MaxBuiltinArrayFunctionArgumentCount);
     const Parameter* args[MaxBuiltinArrayFunctionArgumentCount] = { nullptr, nullptr, nullptr, nullptr };
-    auto cur = arguments.begin();
-    for (size_t i = 0; i < arguments.size(); i++) {
-      args[i] = *cur;
-      ++cur;
-    }
+    for (size_t i = 0; i < arguments.size(); i++)
+      args[i] = arguments[i];
 
     auto bVal = pex::PexValue::Identifier::fromVar(base->generateLoad(file, bldr));
     switch (function.arrayFuncKind) {
@@ -173,11 +171,8 @@ void PapyrusFunctionCallExpression::semantic(PapyrusResolutionContext* ctx, Papy
         if (arguments.size() != argCountMin)
           ctx->reportingContext.fatal(location, "Expected %ull parameters to '%s'!", argCountMin, funcName);
       }
-      auto cur = arguments.begin();
-      for (size_t i = 0; i < arguments.size(); i++) {
-        args[i] = *cur;
-        ++cur;
-      }
+      for (size_t i = 0; i < arguments.size(); i++)
+        args[i] = arguments[i];
     };
 
     switch (function.arrayFuncKind) {
@@ -187,7 +182,7 @@ void PapyrusFunctionCallExpression::semantic(PapyrusResolutionContext* ctx, Papy
         if (arguments.size() == 1) {
           auto p = ctx->allocator->make<Parameter>();
           p->value = ctx->allocator->make<PapyrusLiteralExpression>(location, PapyrusValue::Integer(location, 0));
-          arguments.push_back(p);
+          arguments.push_back(ctx->allocator, p);
         } else {
           if (args[1]->name != "" && !idEq(args[1]->name, "aiStartIndex")) {
             ctx->reportingContext.error(args[1]->value->location,
@@ -224,7 +219,7 @@ void PapyrusFunctionCallExpression::semantic(PapyrusResolutionContext* ctx, Papy
         if (arguments.size() == 2) {
           auto p = ctx->allocator->make<Parameter>();
           p->value = ctx->allocator->make<PapyrusLiteralExpression>(location, PapyrusValue::Integer(location, 0));
-          arguments.push_back(p);
+          arguments.push_back(ctx->allocator, p);
         } else {
           if (args[2]->name != "" && !idEq(args[2]->name, "aiStartIndex")) {
             ctx->reportingContext.error(args[2]->value->location,
@@ -241,7 +236,7 @@ void PapyrusFunctionCallExpression::semantic(PapyrusResolutionContext* ctx, Papy
         if (arguments.size() == 1) {
           auto p = ctx->allocator->make<Parameter>();
           p->value = ctx->allocator->make<PapyrusLiteralExpression>(location, PapyrusValue::Integer(location, -1));
-          arguments.push_back(p);
+          arguments.push_back(ctx->allocator, p);
         } else {
           if (args[1]->name != "" && !idEq(args[1]->name, "aiStartIndex")) {
             ctx->reportingContext.error(args[1]->value->location,
@@ -278,7 +273,7 @@ void PapyrusFunctionCallExpression::semantic(PapyrusResolutionContext* ctx, Papy
         if (arguments.size() == 2) {
           auto p = ctx->allocator->make<Parameter>();
           p->value = ctx->allocator->make<PapyrusLiteralExpression>(location, PapyrusValue::Integer(location, -1));
-          arguments.push_back(p);
+          arguments.push_back(ctx->allocator, p);
         } else {
           if (args[2]->name != "" && !idEq(args[2]->name, "aiStartIndex")) {
             ctx->reportingContext.error(args[2]->value->location,
@@ -295,7 +290,7 @@ void PapyrusFunctionCallExpression::semantic(PapyrusResolutionContext* ctx, Papy
         if (arguments.size() == 1) {
           auto p = ctx->allocator->make<Parameter>();
           p->value = ctx->allocator->make<PapyrusLiteralExpression>(location, PapyrusValue::Integer(location, 1));
-          arguments.push_back(p);
+          arguments.push_back(ctx->allocator, p);
         } else {
           if (args[1]->name != "" && !idEq(args[1]->name, "aiCount")) {
             ctx->reportingContext.error(args[1]->value->location,
@@ -320,7 +315,7 @@ void PapyrusFunctionCallExpression::semantic(PapyrusResolutionContext* ctx, Papy
         if (arguments.size() == 1) {
           auto p = ctx->allocator->make<Parameter>();
           p->value = ctx->allocator->make<PapyrusLiteralExpression>(location, PapyrusValue::Integer(location, 1));
-          arguments.push_back(p);
+          arguments.push_back(ctx->allocator, p);
         } else {
           if (args[1]->name != "" && !idEq(args[1]->name, "aiCount")) {
             ctx->reportingContext.error(args[1]->value->location,
@@ -361,7 +356,7 @@ void PapyrusFunctionCallExpression::semantic(PapyrusResolutionContext* ctx, Papy
         if (arguments.size() == 3) {
           auto p = ctx->allocator->make<Parameter>();
           p->value = ctx->allocator->make<PapyrusLiteralExpression>(location, PapyrusValue::Integer(location, -1));
-          arguments.push_back(p);
+          arguments.push_back(ctx->allocator, p);
         } else {
           if (args[3]->name != "" && !idEq(args[3]->name, "aiCount")) {
             ctx->reportingContext.error(args[3]->value->location,
@@ -400,80 +395,76 @@ void PapyrusFunctionCallExpression::semantic(PapyrusResolutionContext* ctx, Papy
     };
     if (arguments.size() != function.res.func->parameters.size() || hasNamedArgs()) {
       // We may have default args to fill in.
-      IntrusiveLinkedList<Parameter> newArgs;
+      std::vector<Parameter*> newArgs;
+      newArgs.reserve(function.res.func->parameters.size());
       bool hadNamedArgs = false;
-      auto iter = arguments.begin();
-      for (size_t baseI = 0; iter != arguments.end(); baseI++) {
-        if (iter->name != "") {
+      for (size_t baseI = 0; baseI < arguments.size(); baseI++) {
+        auto a = arguments[baseI];
+        if (a->name != "") {
           hadNamedArgs = true;
-          auto newArgsIter = newArgs.beginInsertable();
-          size_t newArgIndex = 0;
+          size_t insertAt = 0;
           for (auto p : function.res.func->parameters) {
-            if (idEq(p->name, iter->name)) {
-              auto a = *iter;
-              ++iter;
+            if (idEq(p->name, a->name)) {
               a->argIndex = p->index;
-              newArgs.insertBefore(newArgsIter, a);
+              newArgs.insert(newArgs.begin() + insertAt, a);
               goto ContinueOuterLoop;
             }
-            if (newArgsIter != newArgs.endInsertable() && newArgsIter->argIndex <= p->index)
-              ++newArgsIter;
-            newArgIndex++;
+            if (insertAt < newArgs.size() && newArgs[insertAt]->argIndex <= p->index)
+              insertAt++;
           }
-          ctx->reportingContext.fatal(iter->value->location,
+          ctx->reportingContext.fatal(a->value->location,
                                       "Unable to find a parameter named '%s'!",
-                                      iter->name.to_string().c_str());
+                                      a->name.to_string().c_str());
         }
         if (hadNamedArgs) {
-          ctx->reportingContext.fatal(iter->value->location,
+          ctx->reportingContext.fatal(a->value->location,
                                       "No normal arguments are allowed after the first named argument!");
         }
 
-        {
-          auto a = *iter;
-          a->argIndex = baseI;
-          ++iter;
-          newArgs.push_back(a);
-        }
+        a->argIndex = baseI;
+        newArgs.push_back(a);
       ContinueOuterLoop:
         continue;
       }
 
-      auto newArgsIter = newArgs.beginInsertable();
+      size_t nextArg = 0;
       for (auto p : function.res.func->parameters) {
-        if (newArgsIter == newArgs.endInsertable() || newArgsIter->argIndex != p->index) {
+        if (nextArg == newArgs.size() || newArgs[nextArg]->argIndex != p->index) {
           if (p->defaultValue.type == PapyrusValueType::Invalid)
             ctx->reportingContext.fatal(location, "Not enough arguments provided.");
           auto newP = ctx->allocator->make<Parameter>();
           newP->argIndex = p->index;
           newP->value = ctx->allocator->make<PapyrusLiteralExpression>(location, p->defaultValue);
-          newArgs.insertBefore(newArgsIter, newP);
-        } else {
-          ++newArgsIter;
+          newArgs.insert(newArgs.begin() + nextArg, newP);
         }
+        nextArg++;
       }
-      arguments = std::move(newArgs);
+      arguments.assign(ctx->allocator, newArgs);
     }
 
-    for (auto p : arguments.lockstepIterate(function.res.func->parameters)) {
-      p.self->value->semantic(ctx);
-      ctx->checkForPoison(p.self->value);
-      switch (p.other->type.type) {
+    size_t argI = 0;
+    for (auto param : function.res.func->parameters) {
+      if (argI == arguments.size())
+        break;
+      auto arg = arguments[argI++];
+      arg->value->semantic(ctx);
+      ctx->checkForPoison(arg->value);
+      switch (param->type.type) {
         case PapyrusType::Kind::CustomEventName:
         case PapyrusType::Kind::ScriptEventName: {
-          bool isCustomEvent = p.other->type.type == PapyrusType::Kind::CustomEventName;
+          bool isCustomEvent = param->type.type == PapyrusType::Kind::CustomEventName;
 
-          auto le = p.self->value->asLiteralExpression();
+          auto le = arg->value->asLiteralExpression();
           if (!le || le->value.type != PapyrusValueType::String) {
-            ctx->reportingContext.error(p.self->value->location,
+            ctx->reportingContext.error(arg->value->location,
                                         "Argument %zu must be string literal.",
-                                        p.other->index);
+                                        param->index);
             continue;
           }
 
           auto baseType = [&]() -> PapyrusType {
-            if (p.other->index != 0)
-              return p.prevSelf->value->resultType();
+            if (param->index != 0)
+              return arguments[param->index - 1]->value->resultType();
             if (baseExpression == nullptr)
               return PapyrusType::ResolvedObject(ctx->object->location, ctx->object);
             return baseExpression->resultType();
@@ -490,7 +481,7 @@ void PapyrusFunctionCallExpression::semantic(PapyrusResolutionContext* ctx, Papy
           }
 
         EventResolutionError:
-          ctx->reportingContext.error(p.self->value->location,
+          ctx->reportingContext.error(arg->value->location,
                                       "Unable to resolve %s event named '%s' in '%s' or one of its parents.",
                                       isCustomEvent ? "a custom" : "an",
                                       le->value.val.s.to_string().c_str(),
@@ -504,13 +495,18 @@ void PapyrusFunctionCallExpression::semantic(PapyrusResolutionContext* ctx, Papy
 
     // We need the semantic pass to have run for the args, but we can't have them coerced until after
     // we've transformed CustomEventName and ScriptEventName parameters.
-    for (auto p : arguments.lockstepIterate(function.res.func->parameters))
-      if (p.other->type.type == PapyrusType::Kind::CustomEventName)
-        p.self->value = ctx->coerceExpression(p.self->value, PapyrusType::String(p.self->value->location));
-      else if (p.other->type.type == PapyrusType::Kind::ScriptEventName)
-        p.self->value = ctx->coerceExpression(p.self->value, PapyrusType::String(p.self->value->location));
+    argI = 0;
+    for (auto param : function.res.func->parameters) {
+      if (argI == arguments.size())
+        break;
+      auto arg = arguments[argI++];
+      if (param->type.type == PapyrusType::Kind::CustomEventName)
+        arg->value = ctx->coerceExpression(arg->value, PapyrusType::String(arg->value->location));
+      else if (param->type.type == PapyrusType::Kind::ScriptEventName)
+        arg->value = ctx->coerceExpression(arg->value, PapyrusType::String(arg->value->location));
       else
-        p.self->value = ctx->coerceExpression(p.self->value, p.other->type);
+        arg->value = ctx->coerceExpression(arg->value, param->type);
+    }
 
     if (function.res.func->name == "GotoState" && arguments.size() == 1) {
       auto le = arguments.front()->value->asLiteralExpression();
@@ -3,6 +3,8 @@
 #include <string>
 #include <vector>
 
+#include <common/ArenaPtr.h>
+
 #include <papyrus/expressions/PapyrusExpression.h>
 #include <papyrus/PapyrusIdentifier.h>
 #include <papyrus/PapyrusType.h>
@@ -17,39 +19,28 @@ struct PapyrusFunctionCallExpression final : public PapyrusExpression {
   struct Parameter final {
     size_t argIndex { 0 };
     identifier_ref name { "" };
-    PapyrusExpression* value { nullptr };
+    ArenaPtr<PapyrusExpression> value {};
 
     explicit Parameter() = default;
     Parameter(const Parameter&) = delete;
     ~Parameter() = default;
-
-  private:
-    template <typename T>
-    friend struct IntrusiveLinkedList;
-    template <typename T>
-    template <typename T2>
-    friend struct IntrusiveLinkedList<T>::LockstepIterator;
-    Parameter* next { nullptr };
   };
   PapyrusIdentifier function;
-  IntrusiveLinkedList<Parameter> arguments {};
+  ArenaSpan<Parameter> arguments {};
 
   explicit PapyrusFunctionCallExpression(CapricaFileLocation loc, PapyrusIdentifier&& f)
-      : PapyrusExpression(loc), function(std::move(f)) { }
+      : PapyrusExpression(loc, PapyrusExpressionKind::FunctionCall), function(std::move(f)) { }
   PapyrusFunctionCallExpression(const PapyrusFunctionCallExpression&) = delete;
-  virtual ~PapyrusFunctionCallExpression() override = default;
 
   pex::PexValue generateLoad(pex::PexFile* file, pex::PexFunctionBuilder& bldr, PapyrusExpression* base) const;
-  virtual pex::PexValue generateLoad(pex::PexFile* file, pex::PexFunctionBuilder& bldr) const override {
+  pex::PexValue generateLoad(pex::PexFile* file, pex::PexFunctionBuilder& bldr) const {
     return generateLoad(file, bldr, nullptr);
   }
 
   void semantic(PapyrusResolutionContext* ctx, PapyrusExpression* baseExpression);
-  virtual void semantic(PapyrusResolutionContext* ctx) override { semantic(ctx, nullptr); }
-
-  virtual PapyrusType resultType() const override;
+  void semantic(PapyrusResolutionContext* ctx) { semantic(ctx, nullptr); }
 
-  virtual PapyrusFunctionCallExpression* asFunctionCallExpression() override { return this; }
+  PapyrusType resultType() const;
 
 private:
   bool isPoisonedReturn { false };
@@ -14,25 +14,22 @@ struct PapyrusIdentifierExpression final : public PapyrusExpression {
   bool isAssignmentContext { false };
 
   explicit PapyrusIdentifierExpression(CapricaFileLocation loc, PapyrusIdentifier&& id)
-      : PapyrusExpression(loc), identifier(std::move(id)) { }
+      : PapyrusExpression(loc, PapyrusExpressionKind::Identifier), identifier(std::move(id)) { }
   PapyrusIdentifierExpression(const PapyrusIdentifierExpression&) = delete;
-  virtual ~PapyrusIdentifierExpression() override = default;
 
-  virtual pex::PexValue generateLoad(pex::PexFile* file, pex::PexFunctionBuilder& bldr) const override {
+  pex::PexValue generateLoad(pex::PexFile* file, pex::PexFunctionBuilder& bldr) const {
     bldr << location;
     return identifier.generateLoad(file, bldr, pex::PexValue::Identifier(file->getString("self")));
   }
 
-  virtual void semantic(PapyrusResolutionContext* ctx) override {
+  void semantic(PapyrusResolutionContext* ctx) {
     identifier = ctx->resolveIdentifier(identifier);
 
     if (!isAssignmentContext)
       identifier.markRead();
   }
 
-  virtual PapyrusType resultType() const override { return identifier.resultType(); }
-
-  virtual PapyrusIdentifierExpression* asIdentifierExpression() override { return this; }
+  PapyrusType resultType() const { return identifier.resultType(); }
 };
 
 }}}
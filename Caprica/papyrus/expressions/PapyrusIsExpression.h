@@ -1,5 +1,7 @@
 #pragma once
 
+#include <common/ArenaPtr.h>
+
 #include <papyrus/expressions/PapyrusExpression.h>
 #include <papyrus/PapyrusType.h>
 
@@ -10,15 +12,14 @@
 namespace caprica { namespace papyrus { namespace expressions {
 
 struct PapyrusIsExpression final : public PapyrusExpression {
-  PapyrusExpression* innerExpression { nullptr };
+  ArenaPtr<PapyrusExpression> innerExpression {};
   PapyrusType targetType;
 
   explicit PapyrusIsExpression(CapricaFileLocation loc, PapyrusType&& tp)
-      : PapyrusExpression(loc), targetType(std::move(tp)) { }
+      : PapyrusExpression(loc, PapyrusExpressionKind::Is), targetType(std::move(tp)) { }
   PapyrusIsExpression(const PapyrusIsExpression&) = delete;
-  virtual ~PapyrusIsExpression() override = default;
 
-  virtual pex::PexValue generateLoad(pex::PexFile* file, pex::PexFunctionBuilder& bldr) const override {
+  pex::PexValue generateLoad(pex::PexFile* file, pex::PexFunctionBuilder& bldr) const {
     namespace op = caprica::pex::op;
 
     auto val = innerExpression->generateLoad(file, bldr);
@@ -28,13 +29,13 @@ struct PapyrusIsExpression final : public PapyrusExpression {
     return dest;
   }
 
-  virtual void semantic(PapyrusResolutionContext* ctx) override {
+  void semantic(PapyrusResolutionContext* ctx) {
     innerExpression->semantic(ctx);
     ctx->checkForPoison(innerExpression);
     targetType = ctx->resolveType(targetType);
   }
 
-  virtual PapyrusType resultType() const override { return PapyrusType::Bool(location); }
+  PapyrusType resultType() const { return PapyrusType::Bool(location); }
 };
 
 }}}
@@ -13,22 +13,19 @@ struct PapyrusLiteralExpression final : public PapyrusExpression {
   PapyrusValue value;
 
   explicit PapyrusLiteralExpression(CapricaFileLocation loc, const PapyrusValue& val)
-      : PapyrusExpression(loc), value(val) { }
+      : PapyrusExpression(loc, PapyrusExpressionKind::Literal), value(val) { }
   explicit PapyrusLiteralExpression(CapricaFileLocation loc, PapyrusValue&& val)
-      : PapyrusExpression(loc), value(std::move(val)) { }
+      : PapyrusExpression(loc, PapyrusExpressionKind::Literal), value(std::move(val)) { }
   PapyrusLiteralExpression(const PapyrusLiteralExpression&) = delete;
-  virtual ~PapyrusLiteralExpression() override = default;
 
-  virtual pex::PexValue generateLoad(pex::PexFile* file, pex::PexFunctionBuilder& bldr) const override {
+  pex::PexValue generateLoad(pex::PexFile* file, pex::PexFunctionBuilder& bldr) const {
     bldr << location;
     return value.buildPex(file);
   }
 
-  virtual void semantic(PapyrusResolutionContext*) override { }
+  void semantic(PapyrusResolutionContext*) { }
 
-  virtual PapyrusType resultType() const override { return value.getPapyrusType(); }
-
-  virtual PapyrusLiteralExpression* asLiteralExpression() override { return this; }
+  PapyrusType resultType() const { return value.getPapyrusType(); }
 };
 
 }}}
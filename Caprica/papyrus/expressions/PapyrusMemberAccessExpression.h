@@ -1,7 +1,10 @@
 #pragma once
 
+#include <common/ArenaPtr.h>
+
 #include <papyrus/expressions/PapyrusArrayLengthExpression.h>
 #include <papyrus/expressions/PapyrusExpression.h>
+#include <papyrus/expressions/PapyrusFunctionCallExpression.h>
 #include <papyrus/expressions/PapyrusIdentifierExpression.h>
 #include <papyrus/PapyrusType.h>
 
@@ -12,14 +15,13 @@
 namespace caprica { namespace papyrus { namespace expressions {
 
 struct PapyrusMemberAccessExpression final : public PapyrusExpression {
-  PapyrusExpression* baseExpression { nullptr };
-  PapyrusExpression* accessExpression { nullptr };
+  ArenaPtr<PapyrusExpression> baseExpression {};
+  ArenaPtr<PapyrusExpression> accessExpression {};
 
-  explicit PapyrusMemberAccessExpression(CapricaFileLocation loc) : PapyrusExpression(loc) { }
+  explicit PapyrusMemberAccessExpression(CapricaFileLocation loc) : PapyrusExpression(loc, PapyrusExpressionKind::MemberAccess) { }
   PapyrusMemberAccessExpression(const PapyrusMemberAccessExpression&) = delete;
-  virtual ~PapyrusMemberAccessExpression() override = default;
 
-  virtual pex::PexValue generateLoad(pex::PexFile* file, pex::PexFunctionBuilder& bldr) const override {
+  pex::PexValue generateLoad(pex::PexFile* file, pex::PexFunctionBuilder& bldr) const {
     namespace op = caprica::pex::op;
     pex::PexValue dest;
     if (auto id = accessExpression->asIdentifierExpression()) {
@@ -53,7 +55,7 @@ struct PapyrusMemberAccessExpression final : public PapyrusExpression {
       CapricaReportingContext::logicalFatal("Invalid access expression for PapyrusMemberAccessExpression!");
   }
 
-  virtual void semantic(PapyrusResolutionContext* ctx) override {
+  void semantic(PapyrusResolutionContext* ctx) {
     // We don't explicitly use the access expression, so we don't
     // check it for poison.
     if (auto fc = accessExpression->asFunctionCallExpression()) {
@@ -90,9 +92,7 @@ struct PapyrusMemberAccessExpression final : public PapyrusExpression {
     }
   }
 
-  virtual PapyrusType resultType() const override { return accessExpression->resultType(); }
-
-  virtual PapyrusMemberAccessExpression* asMemberAccessExpression() override { return this; }
+  PapyrusType resultType() const { return accessExpression->resultType(); }
 };
 
 }}}
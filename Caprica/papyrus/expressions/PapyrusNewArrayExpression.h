@@ -1,5 +1,6 @@
 #pragma once
 
+#include <common/ArenaPtr.h>
 #include <common/EngineLimits.h>
 
 #include <papyrus/expressions/PapyrusExpression.h>
@@ -14,14 +15,13 @@ namespace caprica { namespace papyrus { namespace expressions {
 
 struct PapyrusNewArrayExpression final : public PapyrusExpression {
   PapyrusType type;
-  PapyrusExpression* lengthExpression { nullptr };
+  ArenaPtr<PapyrusExpression> lengthExpression {};
 
   explicit PapyrusNewArrayExpression(CapricaFileLocation loc, PapyrusType&& tp)
-      : PapyrusExpression(loc), type(std::move(tp)) { }
+      : PapyrusExpression(loc, PapyrusExpressionKind::NewArray), type(std::move(tp)) { }
   PapyrusNewArrayExpression(const PapyrusNewArrayExpression&) = delete;
-  virtual ~PapyrusNewArrayExpression() override = default;
 
-  virtual pex::PexValue generateLoad(pex::PexFile* file, pex::PexFunctionBuilder& bldr) const override {
+  pex::PexValue generateLoad(pex::PexFile* file, pex::PexFunctionBuilder& bldr) const {
     namespace op = caprica::pex::op;
     auto len = lengthExpression->generateLoad(file, bldr);
     bldr << location;
@@ -30,7 +30,7 @@ struct PapyrusNewArrayExpression final : public PapyrusExpression {
     return dest;
   }
 
-  virtual void semantic(PapyrusResolutionContext* ctx) override {
+  void semantic(PapyrusResolutionContext* ctx) {
     type = ctx->resolveType(type);
     type = PapyrusType::Array(type.location, ctx->allocator->make<PapyrusType>(type));
     lengthExpression->semantic(ctx);
@@ -56,7 +56,7 @@ struct PapyrusNewArrayExpression final : public PapyrusExpression {
     }
   }
 
-  virtual PapyrusType resultType() const override { return type; }
+  PapyrusType resultType() const { return type; }
 };
 
 }}}
@@ -13,11 +13,10 @@ struct PapyrusNewStructExpression final : public PapyrusExpression {
   PapyrusType type;
 
   explicit PapyrusNewStructExpression(CapricaFileLocation loc, PapyrusType&& tp)
-      : PapyrusExpression(loc), type(std::move(tp)) { }
+      : PapyrusExpression(loc, PapyrusExpressionKind::NewStruct), type(std::move(tp)) { }
   PapyrusNewStructExpression(const PapyrusNewStructExpression&) = delete;
-  virtual ~PapyrusNewStructExpression() override = default;
 
-  virtual pex::PexValue generateLoad(pex::PexFile*, pex::PexFunctionBuilder& bldr) const override {
+  pex::PexValue generateLoad(pex::PexFile*, pex::PexFunctionBuilder& bldr) const {
     namespace op = caprica::pex::op;
     bldr << location;
     auto dest = bldr.allocTemp(type);
@@ -25,9 +24,9 @@ struct PapyrusNewStructExpression final : public PapyrusExpression {
     return dest;
   }
 
-  virtual void semantic(PapyrusResolutionContext* ctx) override { type = ctx->resolveType(type); }
+  void semantic(PapyrusResolutionContext* ctx) { type = ctx->resolveType(type); }
 
-  virtual PapyrusType resultType() const override { return type; }
+  PapyrusType resultType() const { return type; }
 };
 
 }}}
@@ -16,15 +16,14 @@ struct PapyrusParentExpression final : public PapyrusExpression {
   PapyrusType type;
 
   explicit PapyrusParentExpression(CapricaFileLocation loc, const PapyrusType& tp)
-      : PapyrusExpression(loc), type(tp) { }
+      : PapyrusExpression(loc, PapyrusExpressionKind::Parent), type(tp) { }
   PapyrusParentExpression(const PapyrusParentExpression&) = delete;
-  virtual ~PapyrusParentExpression() override = default;
 
-  virtual pex::PexValue generateLoad(pex::PexFile* file, pex::PexFunctionBuilder&) const override {
+  pex::PexValue generateLoad(pex::PexFile* file, pex::PexFunctionBuilder&) const {
     return pex::PexValue::Identifier(file->getString("parent"));
   }
 
-  virtual void semantic(PapyrusResolutionContext* ctx) override {
+  void semantic(PapyrusResolutionContext* ctx) {
     type = ctx->resolveType(type);
     if (ctx->object->parentClass != type)
       ctx->reportingContext.fatal(location, "An error occured while resolving the parent type!");
@@ -32,9 +31,7 @@ struct PapyrusParentExpression final : public PapyrusExpression {
       ctx->reportingContext.fatal(location, "Parent is invalid in a script with no parent!");
   }
 
-  virtual PapyrusType resultType() const override { return type; }
-
-  virtual PapyrusParentExpression* asParentExpression() override { return this; }
+  PapyrusType resultType() const { return type; }
 };
 
 }}}
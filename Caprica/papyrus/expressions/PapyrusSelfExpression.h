@@ -16,21 +16,20 @@ struct PapyrusSelfExpression final : public PapyrusExpression {
   PapyrusType type;
 
   explicit PapyrusSelfExpression(CapricaFileLocation loc, PapyrusType&& tp)
-      : PapyrusExpression(loc), type(std::move(tp)) { }
+      : PapyrusExpression(loc, PapyrusExpressionKind::Self), type(std::move(tp)) { }
   PapyrusSelfExpression(const PapyrusSelfExpression&) = delete;
-  virtual ~PapyrusSelfExpression() override = default;
 
-  virtual pex::PexValue generateLoad(pex::PexFile* file, pex::PexFunctionBuilder&) const override {
+  pex::PexValue generateLoad(pex::PexFile* file, pex::PexFunctionBuilder&) const {
     return pex::PexValue::Identifier(file->getString("self"));
   }
 
-  virtual void semantic(PapyrusResolutionContext* ctx) override {
+  void semantic(PapyrusResolutionContext* ctx) {
     type = ctx->resolveType(type);
     if (ctx->object != type.resolved.obj)
       ctx->reportingContext.fatal(location, "An error occured while resolving the self type!");
   }
 
-  virtual PapyrusType resultType() const override { return type; }
+  PapyrusType resultType() const { return type; }
 };
 
 }}}
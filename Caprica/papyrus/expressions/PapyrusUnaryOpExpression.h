@@ -1,5 +1,7 @@
 #pragma once
 
+#include <common/ArenaPtr.h>
+
 #include <papyrus/expressions/PapyrusExpression.h>
 
 #include <pex/PexFile.h>
@@ -17,13 +19,12 @@ enum class PapyrusUnaryOperatorType {
 
 struct PapyrusUnaryOpExpression final : public PapyrusExpression {
   PapyrusUnaryOperatorType operation { PapyrusUnaryOperatorType::None };
-  PapyrusExpression* innerExpression { nullptr };
+  ArenaPtr<PapyrusExpression> innerExpression {};
 
-  explicit PapyrusUnaryOpExpression(CapricaFileLocation loc) : PapyrusExpression(loc) { }
+  explicit PapyrusUnaryOpExpression(CapricaFileLocation loc) : PapyrusExpression(loc, PapyrusExpressionKind::UnaryOp) { }
   PapyrusUnaryOpExpression(const PapyrusUnaryOpExpression&) = delete;
-  virtual ~PapyrusUnaryOpExpression() override = default;
 
-  virtual pex::PexValue generateLoad(pex::PexFile* file, pex::PexFunctionBuilder& bldr) const override {
+  pex::PexValue generateLoad(pex::PexFile* file, pex::PexFunctionBuilder& bldr) const {
     namespace op = caprica::pex::op;
     auto iVal = innerExpression->generateLoad(file, bldr);
     auto dest = bldr.allocTemp(this->resultType());
@@ -47,13 +48,13 @@ struct PapyrusUnaryOpExpression final : public PapyrusExpression {
     CapricaReportingContext::logicalFatal("Unknown PapyrusBinaryOperatorType while generating the pex opcodes!");
   }
 
-  virtual void semantic(PapyrusResolutionContext* ctx) override {
+  void semantic(PapyrusResolutionContext* ctx) {
     assert(operation != PapyrusUnaryOperatorType::None);
     innerExpression->semantic(ctx);
     ctx->checkForPoison(innerExpression);
   }
 
-  virtual PapyrusType resultType() const override {
+  PapyrusType resultType() const {
     if (operation == PapyrusUnaryOperatorType::Not)
       return PapyrusType::Bool(location);
     return innerExpression->resultType();
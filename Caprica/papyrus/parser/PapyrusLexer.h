@@ -2,6 +2,8 @@
 
 #include <cstring>
 #include <functional>
+#include <limits>
+#include <memory>
 #include <string>
 #include <string_view>
 
@@ -197,8 +199,15 @@ struct PapyrusLexer {
   };
 
   explicit PapyrusLexer(CapricaReportingContext& repCtx, const std::string& file, std::string_view data)
-      : filename(file), reportingContext(repCtx), alloc(new allocators::ChainedPool(1024 * 4)) {
+      : filename(file),
+        reportingContext(repCtx),
+        // The whole tree goes in one arena, so its nodes can refer to each other with 32-bit offsets.
+        alloc(new allocators::ChainedPool(1024 * 4,
+                                          MemoryOwner::ScriptAst,
+                                          std::make_unique<allocators::ContiguousArena>())) {
     CapricaStats::lexedFilesCount++;
+    if (data.size() > std::numeric_limits<uint32_t>::max())
+      reportingContext.fatal("The file is too large to compile, it must be smaller than 4GB.");
     strm = data.data();
     strmLen = data.size();
     consume(); // set the first token.
@@ -252,7 +261,7 @@ private:
 
   ALWAYS_INLINE
   void advanceChars(int distance) {
-    location.fileOffset += distance;
+    location.fileOffset += (uint32_t)distance;
     strmI += distance;
     strm += distance;
   }
@@ -552,8 +552,10 @@ PapyrusFunction* PapyrusParser::parseFunction(
   expectConsumeEOLs();
   func->documentationComment = maybeConsumeDocStringRef();
   if (!func->isNative()) {
+    auto start = pendingStatements.size();
     while (cur.type != endToken && cur.type != TokenType::END)
-      func->statements.push_back(parseStatement(func));
+      pendingStatements.push_back(parseStatement(func));
+    takePending(pendingStatements, start, func->statements);
 
     if (cur.type == TokenType::END)
       reportingContext.fatal(cur.location, "Unexpected EOF in state body!");
@@ -584,15 +586,19 @@ statements::PapyrusStatement* PapyrusParser::parseStatement(PapyrusFunction* fun
       else if (cur.type != TokenType::Identifier)
         reportingContext.fatal(cur.location, "Syntax error: Incorrect Guard Statement");
       size_t idx = 0;
+      auto paramsStart = pendingLockParams.size();
       do {
         maybeConsume(TokenType::Comma);
         auto guard = alloc->make<PapyrusLockParameter>(cur.location, idx++);
         guard->name = expectConsumeIdentRef();
-        ret->lockParams.push_back(guard);
+        pendingLockParams.push_back(guard);
       } while (cur.type == TokenType::Comma);
+      takePending(pendingLockParams, paramsStart, ret->lockParams);
       expectConsumeEOLs();
+      auto start = pendingStatements.size();
       while (!maybeConsume(TokenType::kEndGuard))
-        ret->body.push_back(parseStatement(func));
+        pendingStatements.push_back(parseStatement(func));
+      takePending(pendingStatements, start, ret->body);
       expectConsumeEOLs();
       return ret;
     }
@@ -604,37 +610,47 @@ statements::PapyrusStatement* PapyrusParser::parseStatement(PapyrusFunction* fun
       else if (cur.type != TokenType::Identifier)
         reportingContext.fatal(cur.location, "Syntax error: Incorrect TryGuard Statement");
       size_t idx = 0;
+      auto paramsStart = pendingLockParams.size();
       do {
         maybeConsume(TokenType::Comma);
         auto guard = alloc->make<PapyrusLockParameter>(cur.location, idx++);
         guard->name = expectConsumeIdentRef();
-        ret->lockParams.push_back(guard);
+        pendingLockParams.push_back(guard);
       } while (cur.type == TokenType::Comma);
+      takePending(pendingLockParams, paramsStart, ret->lockParams);
       expectConsumeEOLs();
+      auto start = pendingStatements.size();
       while (!maybeConsume(TokenType::kEndGuard))
-        ret->body.push_back(parseStatement(func));
+        pendingStatements.push_back(parseStatement(func));
+      takePending(pendingStatements, start, ret->body);
       expectConsumeEOLs();
       return ret;
     }
 
     case TokenType::kIf: {
       auto ret = alloc->make<statements::PapyrusIfStatement>(consumeLocation());
+      auto bodiesStart = pendingIfBodies.size();
       while (true) {
-        auto cond = parseExpression(func);
+        auto ifBody = alloc->make<statements::PapyrusIfStatement::IfBody>();
+        ifBody->condition = parseExpression(func);
         expectConsumeEOLs();
-        IntrusiveLinkedList<statements::PapyrusStatement> curStatements {};
+        auto start = pendingStatements.size();
         while (cur.type != TokenType::kElseIf && cur.type != TokenType::kElse && cur.type != TokenType::kEndIf)
-          curStatements.push_back(parseStatement(func));
-        ret->ifBodies.push_back(alloc->make<statements::PapyrusIfStatement::IfBody>(cond, std::move(curStatements)));
+          pendingStatements.push_back(parseStatement(func));
+        takePending(pendingStatements, start, ifBody->body);
+        pendingIfBodies.push_back(ifBody);
         if (cur.type == TokenType::kElseIf) {
           consume();
           continue;
         }
+        takePending(pendingIfBodies, bodiesStart, ret->ifBodies);
         if (cur.type == TokenType::kElse) {
           consume();
           expectConsumeEOLs();
+          auto elseStart = pendingStatements.size();
           while (cur.type != TokenType::kEndIf)
-            ret->elseStatements.push_back(parseStatement(func));
+            pendingStatements.push_back(parseStatement(func));
+          takePending(pendingStatements, elseStart, ret->elseStatements);
         }
         expectConsume(TokenType::kEndIf);
         expectConsumeEOLs();
@@ -657,8 +673,10 @@ statements::PapyrusStatement* PapyrusParser::parseStatement(PapyrusFunction* fun
     case TokenType::kDo: {
       auto ret = alloc->make<statements::PapyrusDoWhileStatement>(consumeLocation());
       expectConsumeEOLs();
+      auto start = pendingStatements.size();
       while (cur.type != TokenType::kLoopWhile)
-        ret->body.push_back(parseStatement(func));
+        pendingStatements.push_back(parseStatement(func));
+      takePending(pendingStatements, start, ret->body);
       expectConsume(TokenType::kLoopWhile);
       ret->condition = parseExpression(func);
       expectConsumeEOLs();
@@ -692,8 +710,10 @@ statements::PapyrusStatement* PapyrusParser::parseStatement(PapyrusFunction* fun
         ret->stepValue = parseExpression(func);
       expectConsumeEOLs();
 
+      auto start = pendingStatements.size();
       while (!maybeConsume(TokenType::kEndFor))
-        ret->body.push_back(parseStatement(func));
+        pendingStatements.push_back(parseStatement(func));
+      takePending(pendingStatements, start, ret->body);
       expectConsumeEOLs();
 
       return ret;
@@ -719,8 +739,10 @@ statements::PapyrusStatement* PapyrusParser::parseStatement(PapyrusFunction* fun
         expectConsume(TokenType::RParen);
       expectConsumeEOLs();
 
+      auto start = pendingStatements.size();
       while (!maybeConsume(TokenType::kEndForEach))
-        ret->body.push_back(parseStatement(func));
+        pendingStatements.push_back(parseStatement(func));
+      takePending(pendingStatements, start, ret->body);
       expectConsumeEOLs();
 
       return ret;
@@ -731,17 +753,18 @@ statements::PapyrusStatement* PapyrusParser::parseStatement(PapyrusFunction* fun
       ret->condition = parseExpression(func);
       expectConsumeEOLs();
 
+      auto casesStart = pendingCaseBodies.size();
       while (true) {
         switch (cur.type) {
           case TokenType::kCase: {
             consume();
-            auto cond = expectConsumePapyrusValue();
+            auto caseBody = alloc->make<statements::PapyrusSwitchStatement::CaseBody>(expectConsumePapyrusValue());
             expectConsumeEOLs();
-            IntrusiveLinkedList<statements::PapyrusStatement> curStatements {};
+            auto start = pendingStatements.size();
             while (cur.type != TokenType::kCase && cur.type != TokenType::kEndSwitch && cur.type != TokenType::kDefault)
-              curStatements.push_back(parseStatement(func));
-            ret->caseBodies.push_back(
-                alloc->make<statements::PapyrusSwitchStatement::CaseBody>(std::move(cond), std::move(curStatements)));
+              pendingStatements.push_back(parseStatement(func));
+            takePending(pendingStatements, start, caseBody->body);
+            pendingCaseBodies.push_back(caseBody);
             break;
           }
 
@@ -751,14 +774,17 @@ statements::PapyrusStatement* PapyrusParser::parseStatement(PapyrusFunction* fun
             consume();
             expectConsumeEOLs();
 
+            auto start = pendingStatements.size();
             while (cur.type != TokenType::kCase && cur.type != TokenType::kEndSwitch && cur.type != TokenType::kDefault)
-              ret->defaultStatements.push_back(parseStatement(func));
+              pendingStatements.push_back(parseStatement(func));
+            takePending(pendingStatements, start, ret->defaultStatements);
             break;
           }
 
           case TokenType::kEndSwitch:
             consume();
             expectConsumeEOLs();
+            takePending(pendingCaseBodies, casesStart, ret->caseBodies);
             return ret;
 
           default:
@@ -771,8 +797,10 @@ statements::PapyrusStatement* PapyrusParser::parseStatement(PapyrusFunction* fun
       auto ret = alloc->make<statements::PapyrusWhileStatement>(consumeLocation());
       ret->condition = parseExpression(func);
       expectConsumeEOLs();
+      auto start = pendingStatements.size();
       while (cur.type != TokenType::kEndWhile)
-        ret->body.push_back(parseStatement(func));
+        pendingStatements.push_back(parseStatement(func));
+      takePending(pendingStatements, start, ret->body);
       expectConsume(TokenType::kEndWhile);
       expectConsumeEOLs();
       return ret;
@@ -1147,6 +1175,7 @@ expressions::PapyrusExpression* PapyrusParser::parseFuncOrIdExpression(PapyrusFu
         expectConsume(TokenType::LParen);
 
         if (cur.type != TokenType::RParen) {
+          auto start = pendingArguments.size();
           do {
             maybeConsume(TokenType::Comma);
 
@@ -1156,8 +1185,9 @@ expressions::PapyrusExpression* PapyrusParser::parseFuncOrIdExpression(PapyrusFu
               expectConsume(TokenType::Equal);
             }
             param->value = parseExpression(func);
-            fCallExpr->arguments.push_back(param);
+            pendingArguments.push_back(param);
           } while (cur.type == TokenType::Comma);
+          takePending(pendingArguments, start, fCallExpr->arguments);
         }
         expectConsume(TokenType::RParen);
 
@@ -1293,13 +1323,11 @@ PapyrusUserFlags PapyrusParser::maybeConsumeUserFlags(CapricaUserFlagsDefinition
       case TokenType::Identifier:
       case TokenType::kDefault: {
         auto loc = cur.location;
-        auto str = cur.val.s.to_string();
-        if (cur.type == TokenType::kDefault)
-          str = "default";
+        auto name = cur.type == TokenType::kDefault ? identifier_ref("default") : cur.val.s;
 
-        auto& flg = conf::Papyrus::userFlagsDefinition.findFlag(reportingContext, loc, str);
+        auto& flg = conf::Papyrus::userFlagsDefinition.findFlag(reportingContext, loc, name);
         if (!flg.isValidOn(validLocs))
-          reportingContext.error(loc, "The flag '%s' is not valid in this location.", str.c_str());
+          reportingContext.error(loc, "The flag '%s' is not valid in this location.", flg.name.c_str());
 
         PapyrusUserFlags newFlag;
         newFlag.data = flg.getData();
@@ -1,14 +1,20 @@
 #pragma once
 
 #include <string>
+#include <vector>
 
+#include <common/ArenaPtr.h>
 #include <common/CapricaReportingContext.h>
 #include <common/CapricaUserFlagsDefinition.h>
 
 #include <papyrus/expressions/PapyrusExpression.h>
+#include <papyrus/expressions/PapyrusFunctionCallExpression.h>
+#include <papyrus/PapyrusLockParameter.h>
 #include <papyrus/PapyrusScript.h>
 #include <papyrus/parser/PapyrusLexer.h>
+#include <papyrus/statements/PapyrusIfStatement.h>
 #include <papyrus/statements/PapyrusStatement.h>
+#include <papyrus/statements/PapyrusSwitchStatement.h>
 
 namespace caprica { namespace papyrus { namespace parser {
 
@@ -21,6 +27,22 @@ struct PapyrusParser final : private PapyrusLexer {
   PapyrusScript* parseScript();
 
 private:
+  // The elements of the lists that are still being parsed, innermost list
+  // last. A list's elements are only copied out to a span in the script's
+  // arena once the whole list has been parsed, so that they end up together.
+  std::vector<statements::PapyrusStatement*> pendingStatements {};
+  std::vector<statements::PapyrusIfStatement::IfBody*> pendingIfBodies {};
+  std::vector<statements::PapyrusSwitchStatement::CaseBody*> pendingCaseBodies {};
+  std::vector<expressions::PapyrusFunctionCallExpression::Parameter*> pendingArguments {};
+  std::vector<PapyrusLockParameter*> pendingLockParams {};
+
+  // Moves the elements pushed since `start` out to `span`.
+  template <typename T>
+  void takePending(std::vector<T*>& pending, size_t start, ArenaSpan<T>& span) {
+    span.assign(alloc, pending.data() + start, pending.size() - start);
+    pending.resize(start);
+  }
+
   PapyrusObject* parseObject(PapyrusScript* script);
   PapyrusState* parseState(PapyrusScript* script, PapyrusObject* object, bool isAuto);
   PapyrusStruct* parseStruct(PapyrusScript* script, PapyrusObject* object);
@@ -1,10 +1,13 @@
 #pragma once
 
+#include <common/ArenaPtr.h>
 #include <common/CapricaConfig.h>
 
 #include <papyrus/expressions/PapyrusArrayIndexExpression.h>
 #include <papyrus/expressions/PapyrusBinaryOpExpression.h>
+#include <papyrus/expressions/PapyrusCastExpression.h>
 #include <papyrus/expressions/PapyrusExpression.h>
+#include <papyrus/expressions/PapyrusFunctionCallExpression.h>
 #include <papyrus/expressions/PapyrusIdentifierExpression.h>
 #include <papyrus/expressions/PapyrusMemberAccessExpression.h>
 #include <papyrus/statements/PapyrusStatement.h>
@@ -26,21 +29,21 @@ enum class PapyrusAssignOperatorType {
 };
 
 struct PapyrusAssignStatement final : public PapyrusStatement {
-  expressions::PapyrusExpression* lValue { nullptr };
+  ArenaPtr<expressions::PapyrusExpression> lValue {};
   PapyrusAssignOperatorType operation { PapyrusAssignOperatorType::None };
-  expressions::PapyrusExpression* rValue { nullptr };
-  expressions::PapyrusBinaryOpExpression* binOpExpression { nullptr };
+  ArenaPtr<expressions::PapyrusExpression> rValue {};
+  ArenaPtr<expressions::PapyrusBinaryOpExpression> binOpExpression {};
 
-  explicit PapyrusAssignStatement(CapricaFileLocation loc) : PapyrusStatement(loc) { }
+  explicit PapyrusAssignStatement(CapricaFileLocation loc) : PapyrusStatement(loc, PapyrusStatementKind::Assign) { }
   PapyrusAssignStatement(const PapyrusAssignStatement&) = delete;
-  virtual ~PapyrusAssignStatement() override = default;
+  ~PapyrusAssignStatement() = default;
 
-  virtual bool buildCFG(PapyrusCFG& cfg) const override {
+  bool buildCFG(PapyrusCFG& cfg) const {
     cfg.appendStatement(this);
     return false;
   }
 
-  virtual void buildPex(pex::PexFile* file, pex::PexFunctionBuilder& bldr) const override {
+  void buildPex(pex::PexFile* file, pex::PexFunctionBuilder& bldr) const {
     namespace op = caprica::pex::op;
     pex::PexValue rVal;
     if (binOpExpression) {
@@ -49,7 +52,7 @@ struct PapyrusAssignStatement final : public PapyrusStatement {
       rVal = rValue->generateLoad(file, bldr);
       if (conf::Papyrus::game == GameID::Skyrim && rVal.type == pex::PexValueType::Invalid) {
         // check if if the rValue is the result of a function call
-        auto travRValueExpression = rValue;
+        auto travRValueExpression = rValue.get();
         while (true) {
           if (auto fc = travRValueExpression->asFunctionCallExpression()) {
             // this was a void method call that was assigned to this variable; change it to None and emit a warning
@@ -87,7 +90,7 @@ struct PapyrusAssignStatement final : public PapyrusStatement {
     }
   }
 
-  virtual void semantic(PapyrusResolutionContext* ctx) override {
+  void semantic(PapyrusResolutionContext* ctx) {
     if (auto id = lValue->asIdentifierExpression())
       id->isAssignmentContext = true;
 
@@ -142,7 +145,8 @@ struct PapyrusAssignStatement final : public PapyrusStatement {
     }
   }
 
-  virtual void visit(PapyrusStatementVisitor& visitor) override { visitor.visit(this); }
+  template <typename F>
+  void forEachChild(F&&) { }
 };
 
 }}}
@@ -8,27 +8,28 @@
 namespace caprica { namespace papyrus { namespace statements {
 
 struct PapyrusBreakStatement final : public PapyrusStatement {
-  explicit PapyrusBreakStatement(CapricaFileLocation loc) : PapyrusStatement(loc) { }
+  explicit PapyrusBreakStatement(CapricaFileLocation loc) : PapyrusStatement(loc, PapyrusStatementKind::Break) { }
   PapyrusBreakStatement(const PapyrusBreakStatement&) = delete;
-  virtual ~PapyrusBreakStatement() = default;
+  ~PapyrusBreakStatement() = default;
 
-  virtual bool buildCFG(PapyrusCFG& cfg) const override {
+  bool buildCFG(PapyrusCFG& cfg) const {
     cfg.markBreakTerminal();
     cfg.terminateNode(PapyrusControlFlowNodeEdgeType::Break);
     return true;
   }
 
-  virtual void buildPex(pex::PexFile*, pex::PexFunctionBuilder& bldr) const override {
+  void buildPex(pex::PexFile*, pex::PexFunctionBuilder& bldr) const {
     namespace op = caprica::pex::op;
     bldr << op::jmp { bldr.currentBreakTarget() };
   }
 
-  virtual void semantic(PapyrusResolutionContext* ctx) override {
+  void semantic(PapyrusResolutionContext* ctx) {
     if (!ctx->canBreak())
       ctx->reportingContext.error(location, "There's nothing to break out of!");
   }
 
-  virtual void visit(PapyrusStatementVisitor& visitor) override { visitor.visit(this); }
+  template <typename F>
+  void forEachChild(F&&) { }
 };
 
 }}}
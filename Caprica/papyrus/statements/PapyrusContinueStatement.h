@@ -8,26 +8,27 @@
 namespace caprica { namespace papyrus { namespace statements {
 
 struct PapyrusContinueStatement final : public PapyrusStatement {
-  explicit PapyrusContinueStatement(CapricaFileLocation loc) : PapyrusStatement(loc) { }
+  explicit PapyrusContinueStatement(CapricaFileLocation loc) : PapyrusStatement(loc, PapyrusStatementKind::Continue) { }
   PapyrusContinueStatement(const PapyrusContinueStatement&) = delete;
-  virtual ~PapyrusContinueStatement() = default;
+  ~PapyrusContinueStatement() = default;
 
-  virtual bool buildCFG(PapyrusCFG& cfg) const override {
+  bool buildCFG(PapyrusCFG& cfg) const {
     cfg.terminateNode(PapyrusControlFlowNodeEdgeType::Continue);
     return true;
   }
 
-  virtual void buildPex(pex::PexFile*, pex::PexFunctionBuilder& bldr) const override {
+  void buildPex(pex::PexFile*, pex::PexFunctionBuilder& bldr) const {
     namespace op = caprica::pex::op;
     bldr << op::jmp { bldr.currentContinueTarget() };
   }
 
-  virtual void semantic(PapyrusResolutionContext* ctx) override {
+  void semantic(PapyrusResolutionContext* ctx) {
     if (!ctx->canContinue())
       ctx->reportingContext.error(location, "There's nothing to continue!");
   }
 
-  virtual void visit(PapyrusStatementVisitor& visitor) override { visitor.visit(this); }
+  template <typename F>
+  void forEachChild(F&&) { }
 };
 
 }}}
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <common/ArenaPtr.h>
 #include <common/identifier_ref.h>
 
 #include <papyrus/expressions/PapyrusExpression.h>
@@ -16,22 +17,19 @@ struct PapyrusDeclareStatement final : public PapyrusStatement {
   identifier_ref name { "" };
   bool isAuto { false };
   bool isConst { false };
-  expressions::PapyrusExpression* initialValue { nullptr };
+  ArenaPtr<expressions::PapyrusExpression> initialValue {};
 
   explicit PapyrusDeclareStatement(CapricaFileLocation loc, PapyrusType&& tp)
-      : PapyrusStatement(loc), type(std::move(tp)) { }
+      : PapyrusStatement(loc, PapyrusStatementKind::Declare), type(std::move(tp)) { }
   PapyrusDeclareStatement(const PapyrusDeclareStatement&) = delete;
-  virtual ~PapyrusDeclareStatement() override {
-    if (initialValue)
-      delete initialValue;
-  }
+  ~PapyrusDeclareStatement() = default;
 
-  virtual bool buildCFG(PapyrusCFG& cfg) const override {
+  bool buildCFG(PapyrusCFG& cfg) const {
     cfg.appendStatement(this);
     return false;
   }
 
-  virtual void buildPex(pex::PexFile* file, pex::PexFunctionBuilder& bldr) const override {
+  void buildPex(pex::PexFile* file, pex::PexFunctionBuilder& bldr) const {
     namespace op = caprica::pex::op;
     auto loc = bldr.allocateLocal(name, type);
     if (initialValue) {
@@ -41,7 +39,7 @@ struct PapyrusDeclareStatement final : public PapyrusStatement {
     }
   }
 
-  virtual void semantic(PapyrusResolutionContext* ctx) override {
+  void semantic(PapyrusResolutionContext* ctx) {
     if (isAuto) {
       initialValue->semantic(ctx);
       ctx->checkForPoison(initialValue);
@@ -60,12 +58,13 @@ struct PapyrusDeclareStatement final : public PapyrusStatement {
       ctx->addLocalVariable(this);
   }
 
-  virtual void semantic_skyrim_first_pass(PapyrusResolutionContext* ctx) override {
+  void semantic_skyrim_first_pass(PapyrusResolutionContext* ctx) {
     if (conf::Skyrim::skyrimAllowLocalUseBeforeDeclaration)
       ctx->addLocalVariable(this);
   }
 
-  virtual void visit(PapyrusStatementVisitor& visitor) override { visitor.visit(this); }
+  template <typename F>
+  void forEachChild(F&&) { }
 };
 
 }}}
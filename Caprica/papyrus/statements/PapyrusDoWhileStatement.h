@@ -1,6 +1,6 @@
 #pragma once
 
-#include <common/IntrusiveLinkedList.h>
+#include <common/ArenaPtr.h>
 
 #include <papyrus/expressions/PapyrusExpression.h>
 #include <papyrus/statements/PapyrusStatement.h>
@@ -11,16 +11,16 @@
 namespace caprica { namespace papyrus { namespace statements {
 
 struct PapyrusDoWhileStatement final : public PapyrusStatement {
-  expressions::PapyrusExpression* condition { nullptr };
-  IntrusiveLinkedList<PapyrusStatement> body {};
+  ArenaPtr<expressions::PapyrusExpression> condition {};
+  ArenaSpan<PapyrusStatement> body {};
 
-  explicit PapyrusDoWhileStatement(CapricaFileLocation loc) : PapyrusStatement(loc) { }
+  explicit PapyrusDoWhileStatement(CapricaFileLocation loc) : PapyrusStatement(loc, PapyrusStatementKind::DoWhile) { }
   PapyrusDoWhileStatement(const PapyrusDoWhileStatement&) = delete;
-  virtual ~PapyrusDoWhileStatement() override = default;
+  ~PapyrusDoWhileStatement() = default;
 
-  virtual bool buildCFG(PapyrusCFG& cfg) const override { return cfg.processCommonLoopBody(body); }
+  bool buildCFG(PapyrusCFG& cfg) const { return cfg.processCommonLoopBody(body); }
 
-  virtual void buildPex(pex::PexFile* file, pex::PexFunctionBuilder& bldr) const override {
+  void buildPex(pex::PexFile* file, pex::PexFunctionBuilder& bldr) const {
     namespace op = caprica::pex::op;
     pex::PexLabel* beforeCondition;
     bldr >> beforeCondition;
@@ -43,7 +43,7 @@ struct PapyrusDoWhileStatement final : public PapyrusStatement {
     bldr.popBreakContinueScope();
   }
 
-  virtual void semantic(PapyrusResolutionContext* ctx) override {
+  void semantic(PapyrusResolutionContext* ctx) {
     condition->semantic(ctx);
     ctx->checkForPoison(condition);
     condition = ctx->coerceExpression(condition, PapyrusType::Bool(condition->location));
@@ -58,11 +58,10 @@ struct PapyrusDoWhileStatement final : public PapyrusStatement {
     ctx->popBreakContinueScope();
   }
 
-  virtual void visit(PapyrusStatementVisitor& visitor) override {
-    visitor.visit(this);
-
+  template <typename F>
+  void forEachChild(F&& f) {
     for (auto s : body)
-      s->visit(visitor);
+      f(s);
   }
 };
 
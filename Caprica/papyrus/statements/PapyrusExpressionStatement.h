@@ -1,5 +1,7 @@
 #pragma once
 
+#include <common/ArenaPtr.h>
+
 #include <papyrus/expressions/PapyrusExpression.h>
 #include <papyrus/statements/PapyrusStatement.h>
 
@@ -9,28 +11,29 @@
 namespace caprica { namespace papyrus { namespace statements {
 
 struct PapyrusExpressionStatement final : public PapyrusStatement {
-  expressions::PapyrusExpression* expression { nullptr };
+  ArenaPtr<expressions::PapyrusExpression> expression {};
 
-  explicit PapyrusExpressionStatement(CapricaFileLocation loc) : PapyrusStatement(loc) { }
+  explicit PapyrusExpressionStatement(CapricaFileLocation loc) : PapyrusStatement(loc, PapyrusStatementKind::Expression) { }
   PapyrusExpressionStatement(const PapyrusExpressionStatement&) = delete;
-  virtual ~PapyrusExpressionStatement() override = default;
+  ~PapyrusExpressionStatement() = default;
 
-  virtual bool buildCFG(PapyrusCFG& cfg) const override {
+  bool buildCFG(PapyrusCFG& cfg) const {
     cfg.appendStatement(this);
     return false;
   }
 
-  virtual void buildPex(pex::PexFile* file, pex::PexFunctionBuilder& bldr) const override {
+  void buildPex(pex::PexFile* file, pex::PexFunctionBuilder& bldr) const {
     bldr.freeValueIfTemp(expression->generateLoad(file, bldr));
   }
 
-  virtual void semantic(PapyrusResolutionContext* ctx) override {
+  void semantic(PapyrusResolutionContext* ctx) {
     // We don't explicitly use the result of the expression, so we don't
     // check it for poison.
     expression->semantic(ctx);
   }
 
-  virtual void visit(PapyrusStatementVisitor& visitor) override { visitor.visit(this); }
+  template <typename F>
+  void forEachChild(F&&) { }
 };
 
 }}}
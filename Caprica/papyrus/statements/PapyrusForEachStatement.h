@@ -1,6 +1,6 @@
 #pragma once
 
-#include <common/IntrusiveLinkedList.h>
+#include <common/ArenaPtr.h>
 
 #include <papyrus/expressions/PapyrusExpression.h>
 #include <papyrus/statements/PapyrusDeclareStatement.h>
@@ -12,28 +12,27 @@
 namespace caprica { namespace papyrus { namespace statements {
 
 struct PapyrusForEachStatement final : public PapyrusStatement {
-  PapyrusDeclareStatement* declareStatement { nullptr };
-  expressions::PapyrusExpression* expressionToIterate { nullptr };
-  IntrusiveLinkedList<PapyrusStatement> body {};
+  ArenaPtr<PapyrusDeclareStatement> declareStatement {};
+  ArenaPtr<expressions::PapyrusExpression> expressionToIterate {};
+  ArenaSpan<PapyrusStatement> body {};
   PapyrusIdentifier* getCountIdentifier { nullptr };
   PapyrusIdentifier* getAtIdentifier { nullptr };
 
-  explicit PapyrusForEachStatement(CapricaFileLocation loc) : PapyrusStatement(loc) { }
+  explicit PapyrusForEachStatement(CapricaFileLocation loc) : PapyrusStatement(loc, PapyrusStatementKind::ForEach) { }
   PapyrusForEachStatement(const PapyrusForEachStatement&) = delete;
-  virtual ~PapyrusForEachStatement() override = default;
+  ~PapyrusForEachStatement() = default;
 
-  virtual bool buildCFG(PapyrusCFG& cfg) const override {
+  bool buildCFG(PapyrusCFG& cfg) const {
     cfg.appendStatement(declareStatement);
     return cfg.processCommonLoopBody(body);
   }
-  virtual void buildPex(pex::PexFile* file, pex::PexFunctionBuilder& bldr) const override;
-  virtual void semantic(PapyrusResolutionContext* ctx) override;
-  virtual void visit(PapyrusStatementVisitor& visitor) override {
-    visitor.visit(this);
-
-    declareStatement->visit(visitor);
+  void buildPex(pex::PexFile* file, pex::PexFunctionBuilder& bldr) const;
+  void semantic(PapyrusResolutionContext* ctx);
+  template <typename F>
+  void forEachChild(F&& f) {
+    f(declareStatement);
     for (auto s : body)
-      s->visit(visitor);
+      f(s);
   }
 };
 
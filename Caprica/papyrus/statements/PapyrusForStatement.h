@@ -1,6 +1,6 @@
 #pragma once
 
-#include <common/IntrusiveLinkedList.h>
+#include <common/ArenaPtr.h>
 
 #include <papyrus/expressions/PapyrusExpression.h>
 #include <papyrus/statements/PapyrusDeclareStatement.h>
@@ -12,24 +12,24 @@
 namespace caprica { namespace papyrus { namespace statements {
 
 struct PapyrusForStatement final : public PapyrusStatement {
-  PapyrusDeclareStatement* declareStatement { nullptr };
+  ArenaPtr<PapyrusDeclareStatement> declareStatement {};
   PapyrusIdentifier* iteratorVariable { nullptr };
-  expressions::PapyrusExpression* initialValue { nullptr };
-  expressions::PapyrusExpression* targetValue { nullptr };
-  expressions::PapyrusExpression* stepValue { nullptr };
-  IntrusiveLinkedList<PapyrusStatement> body {};
+  ArenaPtr<expressions::PapyrusExpression> initialValue {};
+  ArenaPtr<expressions::PapyrusExpression> targetValue {};
+  ArenaPtr<expressions::PapyrusExpression> stepValue {};
+  ArenaSpan<PapyrusStatement> body {};
 
-  explicit PapyrusForStatement(const CapricaFileLocation& loc) : PapyrusStatement(loc) { }
+  explicit PapyrusForStatement(const CapricaFileLocation& loc) : PapyrusStatement(loc, PapyrusStatementKind::For) { }
   PapyrusForStatement(const PapyrusForStatement&) = delete;
-  virtual ~PapyrusForStatement() override = default;
+  ~PapyrusForStatement() = default;
 
-  virtual bool buildCFG(PapyrusCFG& cfg) const override {
+  bool buildCFG(PapyrusCFG& cfg) const {
     if (declareStatement)
       cfg.appendStatement(declareStatement);
     return cfg.processCommonLoopBody(body);
   }
 
-  virtual void buildPex(pex::PexFile* file, pex::PexFunctionBuilder& bldr) const override {
+  void buildPex(pex::PexFile* file, pex::PexFunctionBuilder& bldr) const {
     namespace op = caprica::pex::op;
     namespace op = caprica::pex::op;
     pex::PexLabel* beforeCondition;
@@ -145,7 +145,7 @@ struct PapyrusForStatement final : public PapyrusStatement {
     bldr << afterAll;
   }
 
-  virtual void semantic(PapyrusResolutionContext* ctx) override {
+  void semantic(PapyrusResolutionContext* ctx) {
     initialValue->semantic(ctx);
     ctx->checkForPoison(initialValue);
     if (initialValue->resultType().type != PapyrusType::Kind::Int &&
@@ -219,14 +219,13 @@ struct PapyrusForStatement final : public PapyrusStatement {
     ctx->popBreakContinueScope();
   }
 
-  virtual void visit(PapyrusStatementVisitor& visitor) override {
-    visitor.visit(this);
-
+  template <typename F>
+  void forEachChild(F&& f) {
     if (declareStatement)
-      declareStatement->visit(visitor);
+      f(declareStatement);
 
     for (auto s : body)
-      s->visit(visitor);
+      f(s);
   }
 };
 
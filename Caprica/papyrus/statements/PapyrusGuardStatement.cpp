@@ -1,5 +1,7 @@
 #include <papyrus/statements/PapyrusGuardStatement.h>
 
+#include <papyrus/statements/PapyrusStatementVisitor.h>
+
 namespace caprica { namespace papyrus { namespace statements {
 struct PapyrusGuardStatementBodyVisitor : public PapyrusSelectiveStatementVisitor {
   const PapyrusGuardStatement* m_ThisGuardStatement { nullptr };
@@ -8,7 +10,8 @@ struct PapyrusGuardStatementBodyVisitor : public PapyrusSelectiveStatementVisito
   PapyrusGuardStatementBodyVisitor(const PapyrusGuardStatement* thisLockStatement)
       : m_ThisGuardStatement(thisLockStatement) { }
   // TODO: put the reporting context here, make it emit the error message here
-  virtual void visit(PapyrusGuardStatement* ls) override {
+  using PapyrusSelectiveStatementVisitor::visit;
+  void visit(PapyrusGuardStatement* ls) {
     // TODO: Starfield, verify: Scripts do in fact have nested lock guards; need to verify once CK comes out
     for (auto s : ls->lockParams) {
       assert(m_ThisGuardStatement);
@@ -32,7 +35,7 @@ void PapyrusGuardStatement::semantic(PapyrusResolutionContext* ctx) {
   ctx->popLocalVariableScope();
   auto visitor = PapyrusGuardStatementBodyVisitor(this);
   for (auto s : body)
-    s->visit(visitor);
+    walkStatements(s, visitor);
   if (visitor.m_InvalidNestedLocks) {
     // TODO: Starfield, verify
     ctx->reportingContext.fatal(location, "Invalid nested lock found!");
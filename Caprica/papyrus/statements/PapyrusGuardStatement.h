@@ -1,11 +1,11 @@
 #pragma once
 
+#include <common/ArenaPtr.h>
 #include <common/IntrusiveLinkedList.h>
 
 #include <papyrus/expressions/PapyrusExpression.h>
 #include <papyrus/PapyrusLockParameter.h>
 #include <papyrus/statements/PapyrusStatement.h>
-#include <papyrus/statements/PapyrusStatementVisitor.h>
 
 #include <pex/PexFile.h>
 #include <pex/PexFunctionBuilder.h>
@@ -15,13 +15,13 @@ struct PapyrusGuardStatementBodyVisitor;
 struct PapyrusGuardStatement;
 
 struct PapyrusGuardStatement final : public PapyrusStatement {
-  IntrusiveLinkedList<PapyrusStatement> body {};
-  IntrusiveLinkedList<PapyrusLockParameter> lockParams {};
-  explicit PapyrusGuardStatement(CapricaFileLocation loc) : PapyrusStatement(loc) { }
+  ArenaSpan<PapyrusStatement> body {};
+  ArenaSpan<PapyrusLockParameter> lockParams {};
+  explicit PapyrusGuardStatement(CapricaFileLocation loc) : PapyrusStatement(loc, PapyrusStatementKind::Guard) { }
   PapyrusGuardStatement(const PapyrusGuardStatement&) = delete;
-  virtual ~PapyrusGuardStatement() override = default;
+  ~PapyrusGuardStatement() = default;
 
-  virtual bool buildCFG(PapyrusCFG& cfg) const override {
+  bool buildCFG(PapyrusCFG& cfg) const {
     bool isTerminal = true;
 
     cfg.addLeaf();
@@ -34,7 +34,7 @@ struct PapyrusGuardStatement final : public PapyrusStatement {
     return isTerminal;
   }
 
-  virtual void buildPex(pex::PexFile* file, pex::PexFunctionBuilder& bldr) const override {
+  void buildPex(pex::PexFile* file, pex::PexFunctionBuilder& bldr) const {
     namespace op = caprica::pex::op;
     IntrusiveLinkedList<pex::IntrusivePexValue> args;
     for (auto guard : lockParams)
@@ -49,12 +49,12 @@ struct PapyrusGuardStatement final : public PapyrusStatement {
     bldr << op::unlockguards { std::move(args) };
   }
 
-  virtual void semantic(PapyrusResolutionContext* ctx) override;
+  void semantic(PapyrusResolutionContext* ctx);
 
-  virtual void visit(PapyrusStatementVisitor& visitor) override {
-    visitor.visit(this);
+  template <typename F>
+  void forEachChild(F&& f) {
     for (auto s : body)
-      s->visit(visitor);
+      f(s);
   }
 };
 
@@ -1,6 +1,6 @@
 #pragma once
 
-#include <common/IntrusiveLinkedList.h>
+#include <common/ArenaPtr.h>
 
 #include <papyrus/expressions/PapyrusExpression.h>
 #include <papyrus/statements/PapyrusStatement.h>
@@ -12,24 +12,21 @@ namespace caprica { namespace papyrus { namespace statements {
 
 struct PapyrusIfStatement final : public PapyrusStatement {
   struct IfBody final {
-    expressions::PapyrusExpression* condition { nullptr };
-    IntrusiveLinkedList<PapyrusStatement> body {};
+    ArenaPtr<expressions::PapyrusExpression> condition {};
+    ArenaSpan<PapyrusStatement> body {};
 
-    IfBody(expressions::PapyrusExpression* c, IntrusiveLinkedList<PapyrusStatement>&& b)
-        : condition(c), body(std::move(b)) { }
-
-  private:
-    friend IntrusiveLinkedList<IfBody>;
-    IfBody* next { nullptr };
+    IfBody() = default;
+    IfBody(const IfBody&) = delete;
+    ~IfBody() = default;
   };
-  IntrusiveLinkedList<IfBody> ifBodies {};
-  IntrusiveLinkedList<PapyrusStatement> elseStatements {};
+  ArenaSpan<IfBody> ifBodies {};
+  ArenaSpan<PapyrusStatement> elseStatements {};
 
-  explicit PapyrusIfStatement(CapricaFileLocation loc) : PapyrusStatement(loc) { }
+  explicit PapyrusIfStatement(CapricaFileLocation loc) : PapyrusStatement(loc, PapyrusStatementKind::If) { }
   PapyrusIfStatement(const PapyrusIfStatement&) = delete;
-  virtual ~PapyrusIfStatement() override = default;
+  ~PapyrusIfStatement() = default;
 
-  virtual bool buildCFG(PapyrusCFG& cfg) const override {
+  bool buildCFG(PapyrusCFG& cfg) const {
     bool isTerminal = true;
 
     for (auto p : ifBodies) {
@@ -49,12 +46,12 @@ struct PapyrusIfStatement final : public PapyrusStatement {
     return isTerminal;
   }
 
-  virtual void buildPex(pex::PexFile* file, pex::PexFunctionBuilder& bldr) const override {
+  void buildPex(pex::PexFile* file, pex::PexFunctionBuilder& bldr) const {
     namespace op = caprica::pex::op;
     pex::PexLabel* afterAll;
     bldr >> afterAll;
     pex::PexLabel* nextCondition { nullptr };
-    for (auto& ifBody : ifBodies) {
+    for (auto ifBody : ifBodies) {
       if (nextCondition)
         bldr << nextCondition;
       bldr >> nextCondition;
@@ -73,8 +70,8 @@ struct PapyrusIfStatement final : public PapyrusStatement {
     bldr << afterAll;
   }
 
-  virtual void semantic(PapyrusResolutionContext* ctx) override {
-    for (auto& i : ifBodies) {
+  void semantic(PapyrusResolutionContext* ctx) {
+    for (auto i : ifBodies) {
       i->condition->semantic(ctx);
       ctx->checkForPoison(i->condition);
       i->condition = ctx->coerceExpression(i->condition, PapyrusType::Bool(i->condition->location));
@@ -95,14 +92,13 @@ struct PapyrusIfStatement final : public PapyrusStatement {
     ctx->popLocalVariableScope();
   }
 
-  virtual void visit(PapyrusStatementVisitor& visitor) override {
-    visitor.visit(this);
-
+  template <typename F>
+  void forEachChild(F&& f) {
     for (auto i : ifBodies)
       for (auto s : i->body)
-        s->visit(visitor);
+        f(s);
     for (auto s : elseStatements)
-      s->visit(visitor);
+      f(s);
   }
 };
 
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <common/ArenaPtr.h>
+
 #include <papyrus/expressions/PapyrusExpression.h>
 #include <papyrus/statements/PapyrusStatement.h>
 
@@ -10,18 +12,18 @@
 namespace caprica { namespace papyrus { namespace statements {
 
 struct PapyrusReturnStatement final : public PapyrusStatement {
-  expressions::PapyrusExpression* returnValue { nullptr };
+  ArenaPtr<expressions::PapyrusExpression> returnValue {};
 
-  explicit PapyrusReturnStatement(CapricaFileLocation loc) : PapyrusStatement(loc) { }
+  explicit PapyrusReturnStatement(CapricaFileLocation loc) : PapyrusStatement(loc, PapyrusStatementKind::Return) { }
   PapyrusReturnStatement(const PapyrusReturnStatement&) = delete;
-  virtual ~PapyrusReturnStatement() override = default;
+  ~PapyrusReturnStatement() = default;
 
-  virtual bool buildCFG(PapyrusCFG& cfg) const override {
+  bool buildCFG(PapyrusCFG& cfg) const {
     cfg.terminateNode(PapyrusControlFlowNodeEdgeType::Return);
     return true;
   }
 
-  virtual void buildPex(pex::PexFile* file, pex::PexFunctionBuilder& bldr) const override {
+  void buildPex(pex::PexFile* file, pex::PexFunctionBuilder& bldr) const {
     namespace op = caprica::pex::op;
     auto val = !returnValue ? pex::PexValue::None() : returnValue->generateLoad(file, bldr);
     bldr << location;
@@ -30,7 +32,7 @@ struct PapyrusReturnStatement final : public PapyrusStatement {
     bldr << op::ret { val };
   }
 
-  virtual void semantic(PapyrusResolutionContext* ctx) override {
+  void semantic(PapyrusResolutionContext* ctx) {
     if (returnValue) {
       returnValue->semantic(ctx);
       ctx->checkForPoison(returnValue);
@@ -38,7 +40,8 @@ struct PapyrusReturnStatement final : public PapyrusStatement {
     }
   }
 
-  virtual void visit(PapyrusStatementVisitor& visitor) override { visitor.visit(this); }
+  template <typename F>
+  void forEachChild(F&&) { }
 };
 
 }}}
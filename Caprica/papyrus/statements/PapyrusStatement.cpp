@@ -0,0 +1,25 @@
+#include <papyrus/statements/PapyrusStatement.h>
+
+#include <papyrus/statements/PapyrusStatementVisitor.h>
+
+namespace caprica { namespace papyrus { namespace statements {
+
+bool PapyrusStatement::buildCFG(PapyrusCFG& cfg) const {
+  return visitStatement(this, [&](auto stmt) { return stmt->buildCFG(cfg); });
+}
+
+void PapyrusStatement::buildPex(pex::PexFile* file, pex::PexFunctionBuilder& bldr) const {
+  visitStatement(this, [&](auto stmt) { stmt->buildPex(file, bldr); });
+}
+
+void PapyrusStatement::semantic(PapyrusResolutionContext* ctx) {
+  visitStatement(this, [&](auto stmt) { stmt->semantic(ctx); });
+}
+
+void PapyrusStatement::semantic_skyrim_first_pass(PapyrusResolutionContext* ctx) {
+  // Only declarations do anything in the first pass.
+  if (kind == PapyrusStatementKind::Declare)
+    static_cast<PapyrusDeclareStatement*>(this)->semantic_skyrim_first_pass(ctx);
+}
+
+}}}
@@ -1,11 +1,11 @@
 #pragma once
 
+#include <cstdint>
+
 #include <common/CapricaFileLocation.h>
-#include <common/IntrusiveLinkedList.h>
 
 #include <papyrus/PapyrusCFG.h>
 #include <papyrus/PapyrusResolutionContext.h>
-#include <papyrus/statements/PapyrusStatementVisitor.h>
 
 #include <pex/PexFile.h>
 #include <pex/PexFunctionBuilder.h>
@@ -13,22 +13,38 @@
 
 namespace caprica { namespace papyrus { namespace statements {
 
-struct PapyrusStatement abstract {
+enum class PapyrusStatementKind : uint8_t {
+  Assign,
+  Break,
+  Continue,
+  Declare,
+  DoWhile,
+  Expression,
+  For,
+  ForEach,
+  If,
+  Guard,
+  Return,
+  Switch,
+  TryGuard,
+  While,
+};
+
+// Like expressions, statements are dispatched on their kind tag rather than
+// through a vtable; see PapyrusStatementVisitor.h.
+struct PapyrusStatement {
   const CapricaFileLocation location;
+  const PapyrusStatementKind kind;
 
-  explicit PapyrusStatement(CapricaFileLocation loc) : location(loc) { }
+  explicit PapyrusStatement(CapricaFileLocation loc, PapyrusStatementKind k) : location(loc), kind(k) { }
   PapyrusStatement(const PapyrusStatement&) = delete;
-  virtual ~PapyrusStatement() = default;
-
-  virtual bool buildCFG(PapyrusCFG& cfg) const = 0;
-  virtual void buildPex(pex::PexFile* file, pex::PexFunctionBuilder& bldr) const = 0;
-  virtual void semantic(PapyrusResolutionContext* ctx) = 0;
-  virtual void semantic_skyrim_first_pass(PapyrusResolutionContext* ctx) {};
-  virtual void visit(PapyrusStatementVisitor& visitor) = 0;
+  ~PapyrusStatement() = default;
 
-private:
-  friend IntrusiveLinkedList<PapyrusStatement>;
-  PapyrusStatement* next { nullptr };
+  bool buildCFG(PapyrusCFG& cfg) const;
+  void buildPex(pex::PexFile* file, pex::PexFunctionBuilder& bldr) const;
+  void semantic(PapyrusResolutionContext* ctx);
+  void semantic_skyrim_first_pass(PapyrusResolutionContext* ctx);
 };
+static_assert(sizeof(PapyrusStatement) == 8, "The kind should share a word with the location");
 
 }}}
@@ -1,62 +1,71 @@
 #pragma once
 
+#include <type_traits>
+
+#include <common/CapricaReportingContext.h>
+
+#include <papyrus/statements/PapyrusAssignStatement.h>
+#include <papyrus/statements/PapyrusBreakStatement.h>
+#include <papyrus/statements/PapyrusContinueStatement.h>
+#include <papyrus/statements/PapyrusDeclareStatement.h>
+#include <papyrus/statements/PapyrusDoWhileStatement.h>
+#include <papyrus/statements/PapyrusExpressionStatement.h>
+#include <papyrus/statements/PapyrusForEachStatement.h>
+#include <papyrus/statements/PapyrusForStatement.h>
+#include <papyrus/statements/PapyrusGuardStatement.h>
+#include <papyrus/statements/PapyrusIfStatement.h>
+#include <papyrus/statements/PapyrusReturnStatement.h>
+#include <papyrus/statements/PapyrusStatement.h>
+#include <papyrus/statements/PapyrusSwitchStatement.h>
+#include <papyrus/statements/PapyrusTryGuardStatement.h>
+#include <papyrus/statements/PapyrusWhileStatement.h>
+
 namespace caprica { namespace papyrus { namespace statements {
 
-struct PapyrusAssignStatement;
-struct PapyrusBreakStatement;
-struct PapyrusContinueStatement;
-struct PapyrusDeclareStatement;
-struct PapyrusDoWhileStatement;
-struct PapyrusExpressionStatement;
-struct PapyrusForStatement;
-struct PapyrusForEachStatement;
-struct PapyrusIfStatement;
-struct PapyrusGuardStatement;
-struct PapyrusReturnStatement;
-struct PapyrusSwitchStatement;
-struct PapyrusTryGuardStatement;
-struct PapyrusWhileStatement;
-
-struct PapyrusStatementVisitor abstract {
-  explicit PapyrusStatementVisitor() = default;
-  PapyrusStatementVisitor(const PapyrusStatementVisitor&) = delete;
-  virtual ~PapyrusStatementVisitor() = default;
-
-  virtual void visit(PapyrusAssignStatement* s) = 0;
-  virtual void visit(PapyrusBreakStatement* s) = 0;
-  virtual void visit(PapyrusContinueStatement* s) = 0;
-  virtual void visit(PapyrusDeclareStatement* s) = 0;
-  virtual void visit(PapyrusDoWhileStatement* s) = 0;
-  virtual void visit(PapyrusExpressionStatement* s) = 0;
-  virtual void visit(PapyrusForStatement* s) = 0;
-  virtual void visit(PapyrusForEachStatement* s) = 0;
-  virtual void visit(PapyrusIfStatement* s) = 0;
-  virtual void visit(PapyrusGuardStatement* s) = 0;
-  virtual void visit(PapyrusReturnStatement* s) = 0;
-  virtual void visit(PapyrusSwitchStatement* s) = 0;
-  virtual void visit(PapyrusTryGuardStatement* s) = 0;
-  virtual void visit(PapyrusWhileStatement* s) = 0;
-};
+// Calls `visitor` with `stmt` downcast to its concrete type.
+template <typename Stmt, typename Visitor>
+ALWAYS_INLINE decltype(auto) visitStatement(Stmt* stmt, Visitor&& visitor) {
+#define VISIT_KIND(name)                                                                                               \
+  case PapyrusStatementKind::name:                                                                                     \
+    return visitor(static_cast<std::conditional_t<std::is_const_v<Stmt>,                                               \
+                                                  const Papyrus##name##Statement*,                                     \
+                                                  Papyrus##name##Statement*>>(stmt));
+  switch (stmt->kind) {
+    VISIT_KIND(Assign)
+    VISIT_KIND(Break)
+    VISIT_KIND(Continue)
+    VISIT_KIND(Declare)
+    VISIT_KIND(DoWhile)
+    VISIT_KIND(Expression)
+    VISIT_KIND(For)
+    VISIT_KIND(ForEach)
+    VISIT_KIND(If)
+    VISIT_KIND(Guard)
+    VISIT_KIND(Return)
+    VISIT_KIND(Switch)
+    VISIT_KIND(TryGuard)
+    VISIT_KIND(While)
+  }
+#undef VISIT_KIND
+  CapricaReportingContext::logicalFatal("Unknown PapyrusStatementKind!");
+}
+
+// Walks `stmt` and every statement nested in it, calling visitor.visit()
+// with each one downcast to its concrete type, parents before children.
+template <typename Visitor>
+void walkStatements(PapyrusStatement* stmt, Visitor& visitor) {
+  visitStatement(stmt, [&](auto s) {
+    visitor.visit(s);
+    s->forEachChild([&](PapyrusStatement* child) { walkStatements(child, visitor); });
+  });
+}
 
-struct PapyrusSelectiveStatementVisitor abstract : public PapyrusStatementVisitor {
-  explicit PapyrusSelectiveStatementVisitor() = default;
-  PapyrusSelectiveStatementVisitor(const PapyrusSelectiveStatementVisitor&) = delete;
-  virtual ~PapyrusSelectiveStatementVisitor() = default;
-
-  virtual void visit(PapyrusAssignStatement*) override { }
-  virtual void visit(PapyrusBreakStatement*) override { }
-  virtual void visit(PapyrusContinueStatement*) override { }
-  virtual void visit(PapyrusDeclareStatement*) override { }
-  virtual void visit(PapyrusDoWhileStatement*) override { }
-  virtual void visit(PapyrusExpressionStatement*) override { }
-  virtual void visit(PapyrusForStatement*) override { }
-  virtual void visit(PapyrusForEachStatement*) override { }
-  virtual void visit(PapyrusIfStatement*) override { }
-  virtual void visit(PapyrusGuardStatement*) override { }
-  virtual void visit(PapyrusReturnStatement*) override { }
-  virtual void visit(PapyrusSwitchStatement*) override { }
-  virtual void visit(PapyrusTryGuardStatement*) override { }
-  virtual void visit(PapyrusWhileStatement*) override { }
+// A base for visitors that only care about some kinds of statement. Derived
+// visitors should pull these in with a using-declaration, then add overloads
+// for the kinds they want to see.
+struct PapyrusSelectiveStatementVisitor {
+  template <typename T>
+  void visit(T*) { }
 };
 
 }}}
@@ -1,6 +1,6 @@
 #pragma once
 
-#include <common/IntrusiveLinkedList.h>
+#include <common/ArenaPtr.h>
 
 #include <papyrus/expressions/PapyrusExpression.h>
 #include <papyrus/statements/PapyrusStatement.h>
@@ -13,24 +13,21 @@ namespace caprica { namespace papyrus { namespace statements {
 struct PapyrusSwitchStatement final : public PapyrusStatement {
   struct CaseBody final {
     PapyrusValue condition;
-    IntrusiveLinkedList<PapyrusStatement> body {};
+    ArenaSpan<PapyrusStatement> body {};
 
-    CaseBody(PapyrusValue&& c, IntrusiveLinkedList<PapyrusStatement>&& b)
-        : condition(std::move(c)), body(std::move(b)) { }
-
-  private:
-    friend IntrusiveLinkedList<CaseBody>;
-    CaseBody* next { nullptr };
+    explicit CaseBody(PapyrusValue&& c) : condition(std::move(c)) { }
+    CaseBody(const CaseBody&) = delete;
+    ~CaseBody() = default;
   };
-  expressions::PapyrusExpression* condition { nullptr };
-  IntrusiveLinkedList<CaseBody> caseBodies {};
-  IntrusiveLinkedList<PapyrusStatement> defaultStatements {};
+  ArenaPtr<expressions::PapyrusExpression> condition {};
+  ArenaSpan<CaseBody> caseBodies {};
+  ArenaSpan<PapyrusStatement> defaultStatements {};
 
-  explicit PapyrusSwitchStatement(CapricaFileLocation loc) : PapyrusStatement(loc) { }
+  explicit PapyrusSwitchStatement(CapricaFileLocation loc) : PapyrusStatement(loc, PapyrusStatementKind::Switch) { }
   PapyrusSwitchStatement(const PapyrusSwitchStatement&) = delete;
-  virtual ~PapyrusSwitchStatement() override = default;
+  ~PapyrusSwitchStatement() = default;
 
-  virtual bool buildCFG(PapyrusCFG& cfg) const override {
+  bool buildCFG(PapyrusCFG& cfg) const {
     cfg.pushBreakTerminal();
     for (auto p : caseBodies) {
       cfg.addLeaf();
@@ -54,7 +51,7 @@ struct PapyrusSwitchStatement final : public PapyrusStatement {
     return isTerminal;
   }
 
-  virtual void buildPex(pex::PexFile* file, pex::PexFunctionBuilder& bldr) const override {
+  void buildPex(pex::PexFile* file, pex::PexFunctionBuilder& bldr) const {
     namespace op = caprica::pex::op;
 
     auto tmpDest = bldr.allocLongLivedTemp(condition->resultType());
@@ -65,7 +62,7 @@ struct PapyrusSwitchStatement final : public PapyrusStatement {
     bldr >> afterAll;
     bldr.pushBreakScope(afterAll);
     pex::PexLabel* nextCondition { nullptr };
-    for (auto& cBody : caseBodies) {
+    for (auto cBody : caseBodies) {
       if (nextCondition)
         bldr << nextCondition;
       bldr >> nextCondition;
@@ -85,7 +82,7 @@ struct PapyrusSwitchStatement final : public PapyrusStatement {
     bldr << afterAll;
   }
 
-  virtual void semantic(PapyrusResolutionContext* ctx) override {
+  void semantic(PapyrusResolutionContext* ctx) {
     condition->semantic(ctx);
     ctx->checkForPoison(condition);
     if (condition->resultType().type != PapyrusType::Kind::Int &&
@@ -123,14 +120,13 @@ struct PapyrusSwitchStatement final : public PapyrusStatement {
     ctx->popBreakScope();
   }
 
-  virtual void visit(PapyrusStatementVisitor& visitor) override {
-    visitor.visit(this);
-
+  template <typename F>
+  void forEachChild(F&& f) {
     for (auto i : caseBodies)
       for (auto s : i->body)
-        s->visit(visitor);
+        f(s);
     for (auto s : defaultStatements)
-      s->visit(visitor);
+      f(s);
   }
 };
 
@@ -1,14 +1,16 @@
 #include <papyrus/statements/PapyrusTryGuardStatement.h>
 
+#include <papyrus/statements/PapyrusStatementVisitor.h>
+
 namespace caprica { namespace papyrus { namespace statements {
 
 struct PapyrusTryGuardStatementBodyVisitor : public PapyrusSelectiveStatementVisitor {
   const PapyrusTryGuardStatement* m_ThisTryGuardStatement { nullptr };
-  IntrusiveLinkedList<PapyrusReturnStatement> m_ReturnStatements {};
   bool m_InvalidNestedLocks { false };
   PapyrusTryGuardStatementBodyVisitor(const PapyrusTryGuardStatement* thisLockStatement)
       : m_ThisTryGuardStatement(thisLockStatement) { }
-  void visit(PapyrusTryGuardStatement* tls) override {
+  using PapyrusSelectiveStatementVisitor::visit;
+  void visit(PapyrusTryGuardStatement* tls) {
     m_InvalidNestedLocks = true;
     // TODO: Starfield, verify: Scripts do in fact have nested lock guards; need to verify once CK comes out
     for (auto s : tls->lockParams) {
@@ -33,7 +35,7 @@ void PapyrusTryGuardStatement::semantic(PapyrusResolutionContext* ctx) {
   ctx->popLocalVariableScope();
   auto visitor = PapyrusTryGuardStatementBodyVisitor(this);
   for (auto s : body)
-    s->visit(visitor);
+    walkStatements(s, visitor);
   if (visitor.m_InvalidNestedLocks) {
     // TODO: Starfield, verify
     ctx->reportingContext.fatal(location, "Invalid nested lock found!");
@@ -1,11 +1,11 @@
 #pragma once
 
+#include <common/ArenaPtr.h>
 #include <common/IntrusiveLinkedList.h>
 
 #include <papyrus/expressions/PapyrusExpression.h>
 #include <papyrus/PapyrusLockParameter.h>
 #include <papyrus/statements/PapyrusStatement.h>
-#include <papyrus/statements/PapyrusStatementVisitor.h>
 
 #include <pex/PexFile.h>
 #include <pex/PexFunctionBuilder.h>
@@ -13,13 +13,13 @@
 namespace caprica { namespace papyrus { namespace statements {
 
 struct PapyrusTryGuardStatement final : public PapyrusStatement {
-  IntrusiveLinkedList<PapyrusStatement> body {};
-  IntrusiveLinkedList<PapyrusLockParameter> lockParams {};
-  explicit PapyrusTryGuardStatement(CapricaFileLocation loc) : PapyrusStatement(loc) { }
+  ArenaSpan<PapyrusStatement> body {};
+  ArenaSpan<PapyrusLockParameter> lockParams {};
+  explicit PapyrusTryGuardStatement(CapricaFileLocation loc) : PapyrusStatement(loc, PapyrusStatementKind::TryGuard) { }
   PapyrusTryGuardStatement(const PapyrusTryGuardStatement&) = delete;
-  virtual ~PapyrusTryGuardStatement() override = default;
+  ~PapyrusTryGuardStatement() = default;
 
-  virtual bool buildCFG(PapyrusCFG& cfg) const override {
+  bool buildCFG(PapyrusCFG& cfg) const {
     bool isTerminal = true;
 
     cfg.addLeaf();
@@ -33,7 +33,7 @@ struct PapyrusTryGuardStatement final : public PapyrusStatement {
   }
 
   // TODO: Not sure if this is at all correct
-  virtual void buildPex(pex::PexFile* file, pex::PexFunctionBuilder& bldr) const override {
+  void buildPex(pex::PexFile* file, pex::PexFunctionBuilder& bldr) const {
     namespace op = caprica::pex::op;
     IntrusiveLinkedList<pex::IntrusivePexValue> args;
     for (auto guard : lockParams)
@@ -55,12 +55,12 @@ struct PapyrusTryGuardStatement final : public PapyrusStatement {
     bldr << afterAll;
   }
 
-  virtual void semantic(PapyrusResolutionContext* ctx) override;
+  void semantic(PapyrusResolutionContext* ctx);
 
-  virtual void visit(PapyrusStatementVisitor& visitor) override {
-    visitor.visit(this);
+  template <typename F>
+  void forEachChild(F&& f) {
     for (auto s : body)
-      s->visit(visitor);
+      f(s);
   }
 };
 
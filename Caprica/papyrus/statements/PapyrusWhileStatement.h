@@ -1,7 +1,7 @@
 #pragma once
 
+#include <common/ArenaPtr.h>
 #include <common/CapricaFileLocation.h>
-#include <common/IntrusiveLinkedList.h>
 
 #include <papyrus/expressions/PapyrusExpression.h>
 #include <papyrus/statements/PapyrusStatement.h>
@@ -12,16 +12,16 @@
 namespace caprica { namespace papyrus { namespace statements {
 
 struct PapyrusWhileStatement final : public PapyrusStatement {
-  expressions::PapyrusExpression* condition { nullptr };
-  IntrusiveLinkedList<PapyrusStatement> body {};
+  ArenaPtr<expressions::PapyrusExpression> condition {};
+  ArenaSpan<PapyrusStatement> body {};
 
-  explicit PapyrusWhileStatement(CapricaFileLocation loc) : PapyrusStatement(loc) { }
+  explicit PapyrusWhileStatement(CapricaFileLocation loc) : PapyrusStatement(loc, PapyrusStatementKind::While) { }
   PapyrusWhileStatement(const PapyrusWhileStatement&) = delete;
-  virtual ~PapyrusWhileStatement() override = default;
+  ~PapyrusWhileStatement() = default;
 
-  virtual bool buildCFG(PapyrusCFG& cfg) const override { return cfg.processCommonLoopBody(body); }
+  bool buildCFG(PapyrusCFG& cfg) const { return cfg.processCommonLoopBody(body); }
 
-  virtual void buildPex(pex::PexFile* file, pex::PexFunctionBuilder& bldr) const override {
+  void buildPex(pex::PexFile* file, pex::PexFunctionBuilder& bldr) const {
     namespace op = caprica::pex::op;
     pex::PexLabel* beforeCondition;
     bldr >> beforeCondition;
@@ -42,7 +42,7 @@ struct PapyrusWhileStatement final : public PapyrusStatement {
     bldr.popBreakContinueScope();
   }
 
-  virtual void semantic(PapyrusResolutionContext* ctx) override {
+  void semantic(PapyrusResolutionContext* ctx) {
     condition->semantic(ctx);
     ctx->checkForPoison(condition);
     condition = ctx->coerceExpression(condition, PapyrusType::Bool(condition->location));
@@ -57,11 +57,10 @@ struct PapyrusWhileStatement final : public PapyrusStatement {
     ctx->popBreakContinueScope();
   }
 
-  virtual void visit(PapyrusStatementVisitor& visitor) override {
-    visitor.visit(this);
-
+  template <typename F>
+  void forEachChild(F&& f) {
     for (auto s : body)
-      s->visit(visitor);
+      f(s);
   }
 };
 
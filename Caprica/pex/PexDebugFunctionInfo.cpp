@@ -9,9 +9,8 @@ PexDebugFunctionInfo* PexDebugFunctionInfo::read(allocators::ChainedPool* alloc,
   fi->functionName = rdr.read<PexString>();
   fi->functionType = (PexDebugFunctionType)rdr.read<uint8_t>();
   auto lnSize = rdr.read<uint16_t>();
-  fi->instructionLineMap.reserve(lnSize);
-  for (size_t i = 0; i < lnSize; i++)
-    fi->instructionLineMap.push_back(rdr.read<uint16_t>());
+  fi->instructionLineMap.resize(lnSize);
+  rdr.readArray(fi->instructionLineMap.data(), lnSize);
   return fi;
 }
 
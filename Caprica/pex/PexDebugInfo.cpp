@@ -7,7 +7,7 @@ PexDebugInfo* PexDebugInfo::read(allocators::ChainedPool* alloc, PexReader& rdr,
   inf->modificationTime = rdr.read<time_t>();
   auto fSize = rdr.read<uint16_t>();
   for (size_t i = 0; i < fSize; i++)
-    inf->functions.push_back(PexDebugFunctionInfo::read(alloc, rdr));
+    inf->addFunction(PexDebugFunctionInfo::read(alloc, rdr));
   if (gameType == GameID::Skyrim)
     return inf;
   auto pgSize = rdr.read<uint16_t>();
@@ -19,6 +19,46 @@ PexDebugInfo* PexDebugInfo::read(allocators::ChainedPool* alloc, PexReader& rdr,
   return inf;
 }
 
+void PexDebugInfo::addFunction(PexDebugFunctionInfo* info) {
+  functions.push_back(info);
+  // The first function with a name is the one found, as before it was indexed.
+  functionIndex.emplace(makeKey(info->objectName, info->stateName, info->functionName, info->functionType), info);
+}
+
+PexDebugFunctionInfo* PexDebugInfo::findFunction(PexString objectName,
+                                                 PexString stateName,
+                                                 PexString functionName,
+                                                 PexDebugFunctionType functionType) const {
+  auto f = functionIndex.find(makeKey(objectName, stateName, functionName, functionType));
+  if (f == functionIndex.end())
+    return nullptr;
+  return f->second;
+}
+
+void PexDebugInfo::skip(PexReader& rdr, GameID gameType) {
+  rdr.read<time_t>();
+  auto fSize = rdr.read<uint16_t>();
+  for (size_t i = 0; i < fSize; i++) {
+    // Object, state and function names, and the function type.
+    rdr.skip(sizeof(uint16_t) * 3 + sizeof(uint8_t));
+    rdr.skip(rdr.read<uint16_t>() * sizeof(uint16_t));
+  }
+  if (gameType == GameID::Skyrim)
+    return;
+  auto pgSize = rdr.read<uint16_t>();
+  for (size_t i = 0; i < pgSize; i++) {
+    // Object name, group name, documentation string and user flags.
+    rdr.skip(sizeof(uint16_t) * 3 + sizeof(uint32_t));
+    rdr.skip(rdr.read<uint16_t>() * sizeof(uint16_t));
+  }
+  auto soSize = rdr.read<uint16_t>();
+  for (size_t i = 0; i < soSize; i++) {
+    // Object and struct names.
+    rdr.skip(sizeof(uint16_t) * 2);
+    rdr.skip(rdr.read<uint16_t>() * sizeof(uint16_t));
+  }
+}
+
 void PexDebugInfo::write(PexWriter& wtr, GameID gameType) const {
   wtr.write<time_t>(modificationTime);
   wtr.boundWrite<uint16_t>(functions.size());
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <ctime>
+#include <unordered_map>
 
 #include <common/IntrusiveLinkedList.h>
 
@@ -14,6 +15,7 @@ namespace caprica { namespace pex {
 
 struct PexDebugInfo final {
   time_t modificationTime {};
+  // Functions have to be added with addFunction(), so they're indexed.
   IntrusiveLinkedList<PexDebugFunctionInfo> functions {};
   IntrusiveLinkedList<PexDebugPropertyGroup> propertyGroups {};
   IntrusiveLinkedList<PexDebugStructOrder> structOrders {};
@@ -22,8 +24,51 @@ struct PexDebugInfo final {
   PexDebugInfo(const PexDebugInfo&) = delete;
   ~PexDebugInfo() = default;
 
+  // The info has to be filled in before it's added, as that's when it's indexed.
+  void addFunction(PexDebugFunctionInfo* info);
+  // Property accessors don't have a state, so stateName is ignored for them.
+  PexDebugFunctionInfo* findFunction(PexString objectName,
+                                     PexString stateName,
+                                     PexString functionName,
+                                     PexDebugFunctionType functionType) const;
+
   static PexDebugInfo* read(allocators::ChainedPool* alloc, PexReader& rdr, GameID gameType);
+  static void skip(PexReader& rdr, GameID gameType);
   void write(PexWriter& wtr, GameID gameType) const;
+
+private:
+  struct FunctionKey final {
+    size_t objectName;
+    size_t stateName;
+    size_t functionName;
+    PexDebugFunctionType functionType;
+
+    bool operator==(const FunctionKey& other) const noexcept {
+      return objectName == other.objectName && stateName == other.stateName && functionName == other.functionName &&
+             functionType == other.functionType;
+    }
+  };
+  struct FunctionKeyHasher final {
+    size_t operator()(const FunctionKey& k) const noexcept {
+      size_t h = k.objectName;
+      h = h * 31 + k.stateName;
+      h = h * 31 + k.functionName;
+      return h * 31 + (size_t)k.functionType;
+    }
+  };
+
+  // The functions by the string table indices of their names, so that
+  // looking up the debug info of every function in a file isn't quadratic.
+  std::unordered_map<FunctionKey, PexDebugFunctionInfo*, FunctionKeyHasher> functionIndex {};
+
+  static FunctionKey makeKey(PexString objectName,
+                             PexString stateName,
+                             PexString functionName,
+                             PexDebugFunctionType functionType) {
+    if (functionType != PexDebugFunctionType::Normal)
+      stateName = PexString();
+    return FunctionKey { objectName.index, stateName.index, functionName.index, functionType };
+  }
 };
 
 }}
@@ -1,56 +1,53 @@
 #include <pex/PexFile.h>
 
+#include <algorithm>
 #include <fstream>
 #include <iostream>
 
-#include <common/allocators/AtomicCachePool.h>
+#include <common/CapricaConfig.h>
 #include <common/CapricaReportingContext.h>
 
+#include <papyrus/PapyrusWorkerContext.h>
+
 namespace caprica { namespace pex {
 
-static allocators::AtomicCachePool<allocators::ReffyStringPool> stringPoolAllocator;
 PexFile::PexFile(allocators::ChainedPool* p) {
   alloc = p;
-  stringTable = stringPoolAllocator.acquire();
+  stringTable = papyrus::PapyrusWorkerContext::current().stringTables.acquire();
 }
 
 PexFile::~PexFile() {
-  stringPoolAllocator.release(stringTable);
+  if (stringTable)
+    papyrus::PapyrusWorkerContext::current().stringTables.release(stringTable);
+  for (auto a : fragmentAllocators)
+    delete a;
 }
 
 PexDebugFunctionInfo* PexFile::tryFindFunctionDebugInfo(const PexObject* object,
                                                         const PexState* state,
-                                                        const PexFunction* function,
-                                                        const std::string& propertyName,
-                                                        PexDebugFunctionType functionType) {
-  if (debugInfo) {
-    assert(function);
-    assert(object);
-    auto fName = propertyName == "" ? getStringValue(function->name) : propertyName;
-    auto objectName = getStringValue(object->name);
-    auto stateName = state ? getStringValue(state->name) : "";
-
-    for (auto fi : debugInfo->functions) {
-      if (getStringValue(fi->objectName) == objectName && getStringValue(fi->stateName) == stateName &&
-          getStringValue(fi->functionName) == fName && fi->functionType == functionType) {
-        return fi;
-      }
-    }
-  }
-  return nullptr;
-}
-
-const PexDebugFunctionInfo* PexFile::tryFindFunctionDebugInfo(const PexObject* object,
-                                                              const PexState* state,
-                                                              const PexFunction* function,
-                                                              const std::string& propertyName,
-                                                              PexDebugFunctionType functionType) const {
-  return ((PexFile*)this)->tryFindFunctionDebugInfo(object, state, function, propertyName, functionType);
+                                                        PexString functionName,
+                                                        PexDebugFunctionType functionType) const {
+  if (!debugInfo)
+    return nullptr;
+  assert(object);
+  return debugInfo->findFunction(object->name, state ? state->name : PexString(), functionName, functionType);
 }
 
 PexString PexFile::getString(const identifier_ref& str) {
   auto ret = PexString();
-  ret.index = stringTable->lookup(str);
+  ret.index = stringTable->tryLookup(str);
+  if (ret.index == allocators::ReffyStringPool::NotAdded) {
+    if (reportingContext) {
+      reportingContext->fatal("Unable to add the string '%s', the script already uses the maximum of %zu strings a "
+                              ".pex file can hold!",
+                              str.to_string().c_str(),
+                              allocators::ReffyStringPool::MaxCapacity);
+    }
+    CapricaReportingContext::logicalFatal("Unable to add the string '%s', the string table already has the maximum "
+                                          "of %zu strings a .pex file can hold!",
+                                          str.to_string().c_str(),
+                                          allocators::ReffyStringPool::MaxCapacity);
+  }
   return ret;
 }
 
@@ -76,6 +73,75 @@ size_t PexFile::getUserFlagCount() const noexcept {
   return userFlagTable.size();
 }
 
+PexFile* PexFile::createFragment(CapricaReportingContext& repCtx) {
+  auto fragmentAlloc = new allocators::ChainedPool(1024 * 4, MemoryOwner::PexFile);
+  fragmentAllocators.push_back(fragmentAlloc);
+  auto fragment = fragmentAlloc->make<PexFile>(fragmentAlloc);
+  fragment->reportingContext = &repCtx;
+  fragment->majorVersion = majorVersion;
+  fragment->minorVersion = minorVersion;
+  fragment->gameID = gameID;
+  if (debugInfo)
+    fragment->debugInfo = fragmentAlloc->make<PexDebugInfo>();
+  return fragment;
+}
+
+void PexFile::mergeFragment(PexFile* fragment, PexFunction* func) {
+  std::vector<PexString> indices {};
+  indices.reserve(fragment->stringTable->size());
+  for (size_t i = 0; i < fragment->stringTable->size(); i++)
+    indices.push_back(getString(fragment->stringTable->byIndex(i)));
+  const auto renumber = [&indices](PexString& str) {
+    if (str.valid())
+      str = indices[str.index];
+  };
+  const auto renumberValue = [&renumber](PexValue& val) {
+    if (val.type == PexValueType::Identifier || val.type == PexValueType::String)
+      renumber(val.val.s);
+  };
+
+  for (auto& uf : fragment->userFlagTable) {
+    auto name = uf.first;
+    renumber(name);
+    getUserFlag(name, uf.second);
+  }
+
+  renumber(func->name);
+  renumber(func->returnTypeName);
+  renumber(func->documentationString);
+  for (auto p : func->parameters) {
+    renumber(p->name);
+    renumber(p->type);
+  }
+  for (auto l : func->locals) {
+    renumber(l->name);
+    renumber(l->type);
+  }
+  for (auto i : func->instructions) {
+    for (auto& a : i->args)
+      renumberValue(a);
+    for (auto a : i->variadicArgs)
+      renumberValue(*a);
+  }
+
+  if (fragment->debugInfo) {
+    // Adding them to our list relinks them, so they're collected first.
+    std::vector<PexDebugFunctionInfo*> functionInfos {};
+    for (auto f : fragment->debugInfo->functions)
+      functionInfos.push_back(f);
+    for (auto f : functionInfos) {
+      renumber(f->objectName);
+      renumber(f->stateName);
+      renumber(f->functionName);
+      debugInfo->addFunction(f);
+    }
+  }
+
+  // Everything refers to our strings now, so the fragment's table can be reused.
+  papyrus::PapyrusWorkerContext::current().stringTables.release(fragment->stringTable);
+  fragment->stringTable = nullptr;
+}
+
 PexFile* PexFile::read(allocators::ChainedPool* alloc, PexReader& rdr) {
   auto file = alloc->make<PexFile>(alloc);
   rdr.endianness = Endianness::Little; // ensure that we're reading little endian to begin with
@@ -97,18 +163,22 @@ PexFile* PexFile::read(allocators::ChainedPool* alloc, PexReader& rdr) {
   }
   file->gameID = rdr.read<GameID>();
   file->compilationTime = rdr.read<time_t>();
-  file->sourceFileName = alloc->allocateString(rdr.read<std::string>());
+  file->sourceFileName = alloc->allocateString(rdr.read<std::string_view>());
   file->userName = rdr.read<std::string>();
   file->computerName = rdr.read<std::string>();
 
+  // The string table refers to the strings in the reader's buffer
+  // rather than copying them, as the buffer outlives the file.
   auto strTableSize = rdr.read<uint16_t>();
-  for (size_t i = 0; i < strTableSize; i++) {
-    auto str = rdr.read<std::string>();
-    file->stringTable->push_back(str);
-  }
+  for (size_t i = 0; i < strTableSize; i++)
+    file->stringTable->push_back_unowned(rdr.read<std::string_view>());
 
-  if (rdr.read<uint8_t>() != 0)
-    file->debugInfo = PexDebugInfo::read(alloc, rdr, file->gameID);
+  if (rdr.read<uint8_t>() != 0) {
+    if (rdr.interfaceOnly)
+      PexDebugInfo::skip(rdr, file->gameID);
+    else
+      file->debugInfo = PexDebugInfo::read(alloc, rdr, file->gameID);
+  }
 
   auto ufTableSize = rdr.read<uint16_t>();
   file->userFlagTable.reserve(ufTableSize);
@@ -127,6 +197,15 @@ PexFile* PexFile::read(allocators::ChainedPool* alloc, PexReader& rdr) {
 }
 
 void PexFile::write(PexWriter& wtr) const {
+  // The file is measured first, so the writer's buffer
+  // is allocated once, rather than grown as it's written.
+  wtr.beginMeasuring();
+  writeContents(wtr);
+  wtr.reserve(wtr.endMeasuring());
+  writeContents(wtr);
+}
+
+void PexFile::writeContents(PexWriter& wtr) const {
   if (gameID == GameID::Skyrim)
     wtr.endianness = Endianness::Big;
   wtr.write<uint32_t>(PEX_MAGIC_NUM); // Magic Number
@@ -150,9 +229,20 @@ void PexFile::write(PexWriter& wtr) const {
   }
 
   wtr.boundWrite<uint16_t>(userFlagTable.size());
-  for (auto uf : userFlagTable) {
-    wtr.write<PexString>(uf.first);
-    wtr.write<uint8_t>(uf.second);
+  const auto writeUserFlags = [&wtr](const std::vector<std::pair<PexString, uint8_t>>& flags) {
+    for (auto& uf : flags) {
+      wtr.write<PexString>(uf.first);
+      wtr.write<uint8_t>(uf.second);
+    }
+  };
+  if (conf::CodeGeneration::reproducible) {
+    // The table is in the order the flags were first used, so reproducible
+    // builds write it by bit instead, to not depend on that.
+    auto flags = userFlagTable;
+    std::sort(flags.begin(), flags.end(), [](auto& a, auto& b) { return a.second < b.second; });
+    writeUserFlags(flags);
+  } else {
+    writeUserFlags(userFlagTable);
   }
 
   wtr.boundWrite<uint16_t>(objects.size());
@@ -9,6 +9,8 @@
 
 #include <common/allocators/ChainedPool.h>
 #include <common/allocators/ReffyStringPool.h>
+#include <common/CapricaReportingContext.h>
+#include <common/CaselessStringComparer.h>
 #include <common/identifier_ref.h>
 #include <common/IntrusiveLinkedList.h>
 
@@ -43,6 +45,9 @@ struct PexFile final {
   std::string computerName { "" };
   PexDebugInfo* debugInfo { nullptr };
   IntrusiveLinkedList<PexObject> objects {};
+  // Where errors about the file as a whole, like running out of strings,
+  // are reported. Files that are only read don't have one.
+  CapricaReportingContext* reportingContext { nullptr };
 
   explicit PexFile(allocators::ChainedPool* p);
   PexFile(const PexFile&) = delete;
@@ -52,21 +57,26 @@ struct PexFile final {
       debugInfo = alloc->make<PexDebugInfo>();
   }
 
+  // functionName is the name of the function, or of the property for accessors.
   PexDebugFunctionInfo* tryFindFunctionDebugInfo(const PexObject* object,
                                                  const PexState* state,
-                                                 const PexFunction* function,
-                                                 const std::string& propertyName,
-                                                 PexDebugFunctionType functionType);
-  const PexDebugFunctionInfo* tryFindFunctionDebugInfo(const PexObject* object,
-                                                       const PexState* state,
-                                                       const PexFunction* function,
-                                                       const std::string& propertyName,
-                                                       PexDebugFunctionType functionType) const;
+                                                 PexString functionName,
+                                                 PexDebugFunctionType functionType) const;
   PexString getString(const identifier_ref& str);
   identifier_ref getStringValue(const PexString& str) const;
   PexUserFlags getUserFlag(PexString name, uint8_t bitNum);
   size_t getUserFlagCount() const noexcept;
 
+  // A fragment is a file of its own that a function of this file can be
+  // built into on another thread, as it has its own allocator, string table
+  // and user flags. mergeFragment() then adds the fragment's strings and
+  // user flags to this file, in the order the fragment first used them, and
+  // renumbers the function to match, so merging the fragments in the order
+  // the functions would have been built in numbers everything the same as
+  // building them here would have. The fragment is freed with this file.
+  PexFile* createFragment(CapricaReportingContext& repCtx);
+  void mergeFragment(PexFile* fragment, PexFunction* func);
+
   void setGameAndVersion(GameID game) {
     gameID = game;
     switch (game) {
@@ -92,6 +102,7 @@ struct PexFile final {
         break;
     }
   }
+  // The file's strings refer to the reader's buffer, so it has to outlive the file.
   static PexFile* read(allocators::ChainedPool* alloc, PexReader& rdr);
   void write(PexWriter& wtr) const;
   void writeAsm(PexAsmWriter& wtr) const;
@@ -101,10 +112,13 @@ private:
 
   ~PexFile();
 
+  void writeContents(PexWriter& wtr) const;
+
   allocators::ReffyStringPool* stringTable;
 
   std::vector<std::pair<PexString, uint8_t>> userFlagTable;
   std::unordered_map<size_t, size_t> userFlagTableLookup;
+  std::vector<allocators::ChainedPool*> fragmentAllocators;
 };
 
 }
@@ -25,6 +25,14 @@ PexFunction* PexFunction::read(allocators::ChainedPool* alloc, PexReader& rdr, b
   for (size_t i = 0; i < pSize; i++)
     func->parameters.push_back(PexFunctionParameter::read(alloc, rdr));
   auto lSize = rdr.read<uint16_t>();
+  if (rdr.interfaceOnly) {
+    // Each local is a name and a type.
+    rdr.skip(lSize * sizeof(uint16_t) * 2);
+    auto iSize = rdr.read<uint16_t>();
+    for (size_t i = 0; i < iSize; i++)
+      PexInstruction::skip(rdr);
+    return func;
+  }
   for (size_t i = 0; i < lSize; i++)
     func->locals.push_back(PexLocalVariable::read(alloc, rdr));
   auto iSize = rdr.read<uint16_t>();
@@ -62,7 +70,7 @@ void PexFunction::writeAsm(const PexFile* file,
                            const PexObject* obj,
                            const PexState* state,
                            PexDebugFunctionType funcType,
-                           std::string propName,
+                           PexString propName,
                            PexAsmWriter& wtr) const {
   wtr.write(".function ");
   if (funcType == PexDebugFunctionType::Getter)
@@ -102,7 +110,8 @@ void PexFunction::writeAsm(const PexFile* file,
     wtr.writeln(".code");
     wtr.ident++;
 
-    auto debInf = file->tryFindFunctionDebugInfo(obj, state, this, propName, funcType);
+    auto debugName = funcType == PexDebugFunctionType::Normal ? name : propName;
+    auto debInf = file->tryFindFunctionDebugInfo(obj, state, debugName, funcType);
 
     // This is the fun part.
     std::unordered_map<size_t, size_t> labelMap;
@@ -44,7 +44,7 @@ struct PexFunction final {
                 const PexObject* obj,
                 const PexState* state,
                 PexDebugFunctionType funcType,
-                std::string propName,
+                PexString propName,
                 PexAsmWriter& wtr) const;
 
 private:
@@ -1,14 +1,14 @@
 #include <pex/PexFunctionBuilder.h>
 
-#include <common/allocators/CachePool.h>
 #include <common/CapricaReportingContext.h>
 
+#include <papyrus/PapyrusWorkerContext.h>
+
 namespace caprica { namespace pex {
 
-static thread_local allocators::CachePool<FixedPexStringMap<detail::TempVarDescriptor>> stringMapCache {};
 PexFunctionBuilder::PexFunctionBuilder(CapricaReportingContext& repCtx, CapricaFileLocation loc, PexFile* fl)
     : reportingContext(repCtx), currentLocation(loc), file(fl), alloc(fl->alloc) {
-  tempVarMap = stringMapCache.acquire();
+  tempVarMap = papyrus::PapyrusWorkerContext::current().tempVarMaps.acquire();
 }
 
 void PexFunctionBuilder::populateFunction(PexFunction* func, PexDebugFunctionInfo* debInfo) {
@@ -43,7 +43,7 @@ void PexFunctionBuilder::populateFunction(PexFunction* func, PexDebugFunctionInf
     debInfo->instructionLineMap.emplace_back((uint16_t)line);
   }
 
-  stringMapCache.release(tempVarMap);
+  papyrus::PapyrusWorkerContext::current().tempVarMaps.release(tempVarMap);
   tempVarMap = nullptr;
 }
 
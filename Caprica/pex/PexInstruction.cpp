@@ -174,6 +174,42 @@ PexInstruction* PexInstruction::read(allocators::ChainedPool* alloc, PexReader&
   return inst;
 }
 
+void PexInstruction::skip(PexReader& rdr) {
+  auto opCode = (PexOpCode)rdr.read<uint8_t>();
+  if (opCode >= PexOpCode::OPCODECOUNT)
+    CapricaReportingContext::logicalFatal("Unknown PexOpCode: %u", (unsigned)opCode);
+
+  size_t argCount;
+  switch (opCode) {
+    case PexOpCode::LockGuards:
+    case PexOpCode::UnlockGuards:
+      argCount = 0;
+      break;
+    case PexOpCode::TryLockGuards:
+      argCount = 1;
+      break;
+    case PexOpCode::CallMethod:
+    case PexOpCode::CallStatic:
+      argCount = 3;
+      break;
+    case PexOpCode::CallParent:
+      argCount = 2;
+      break;
+    default:
+      for (size_t i = 0, aCount = getArgCountForOpCode(opCode); i < aCount; i++)
+        rdr.read<PexValue>();
+      return;
+  }
+
+  for (size_t i = 0; i < argCount; i++)
+    rdr.read<PexValue>();
+  auto varVal = rdr.read<PexValue>();
+  if (varVal.type != PexValueType::Integer)
+    CapricaReportingContext::logicalFatal("The var arg count for call instructions should be an integer!");
+  for (size_t i = 0; i < varVal.val.i; i++)
+    rdr.read<PexValue>();
+}
+
 void PexInstruction::write(PexWriter& wtr) const {
   wtr.write<uint8_t>((uint8_t)opCode);
   for (auto& a : args)
@@ -161,6 +161,8 @@ struct PexInstruction final {
   static int32_t getDestArgIndexForOpCode(PexOpCode op);
 
   static PexInstruction* read(allocators::ChainedPool* alloc, PexReader& rdr, GameID gameType);
+  // Moves the reader past an instruction without decoding it.
+  static void skip(PexReader& rdr);
   void write(PexWriter& wtr) const;
 
   static PexOpCode tryParseOpCode(const std::string& str);
@@ -78,9 +78,9 @@ void PexOptimizer::optimize(PexFile* file,
                             PexObject* object,
                             PexState* state,
                             PexFunction* function,
-                            const std::string& propertyName,
+                            PexString debugName,
                             PexDebugFunctionType functionType) {
-  PexDebugFunctionInfo* debInfo = file->tryFindFunctionDebugInfo(object, state, function, propertyName, functionType);
+  PexDebugFunctionInfo* debInfo = file->tryFindFunctionDebugInfo(object, state, debugName, functionType);
   auto optimizedInstructions = buildOptInstructions(debInfo, function->instructions);
 
   const auto isDeadBetween = [&optimizedInstructions](size_t startID, size_t endID) -> bool {
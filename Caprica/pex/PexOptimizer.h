@@ -17,18 +17,26 @@ private:
   void optimize(PexFile* file, PexObject* object) {
     for (auto s : object->states)
       optimize(file, object, s);
+    for (auto p : object->properties) {
+      if (p->isAuto)
+        continue;
+      if (p->readFunction)
+        optimize(file, object, nullptr, p->readFunction, p->name, PexDebugFunctionType::Getter);
+      if (p->writeFunction)
+        optimize(file, object, nullptr, p->writeFunction, p->name, PexDebugFunctionType::Setter);
+    }
   }
 
   void optimize(PexFile* file, PexObject* object, PexState* state) {
     for (auto f : state->functions)
-      optimize(file, object, state, f, "", PexDebugFunctionType::Normal);
+      optimize(file, object, state, f, f->name, PexDebugFunctionType::Normal);
   }
 
   void optimize(PexFile* file,
                 PexObject* object,
                 PexState* state,
                 PexFunction* function,
-                const std::string& propertyName,
+                PexString debugName,
                 PexDebugFunctionType functionType);
 };
 }}
@@ -75,12 +75,10 @@ void PexProperty::writeAsm(const PexFile* file, const PexObject* obj, PexAsmWrit
     wtr.writeln(".autoVar %s", file->getStringValue(autoVar).to_string().c_str());
   } else {
     if (isReadable) {
-      readFunction
-          ->writeAsm(file, obj, nullptr, PexDebugFunctionType::Getter, file->getStringValue(name).to_string(), wtr);
+      readFunction->writeAsm(file, obj, nullptr, PexDebugFunctionType::Getter, name, wtr);
     }
     if (isWritable) {
-      writeFunction
-          ->writeAsm(file, obj, nullptr, PexDebugFunctionType::Setter, file->getStringValue(name).to_string(), wtr);
+      writeFunction->writeAsm(file, obj, nullptr, PexDebugFunctionType::Setter, name, wtr);
     }
   }
 
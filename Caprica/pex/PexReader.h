@@ -1,9 +1,8 @@
 #pragma once
 
 #include <cstdint>
-#include <fstream>
-#include <iostream>
 #include <string>
+#include <string_view>
 
 #include <common/CapricaBinaryReader.h>
 #include <common/CapricaReportingContext.h>
@@ -16,7 +15,11 @@
 namespace caprica { namespace pex {
 
 struct PexReader final : public CapricaBinaryReader {
-  explicit PexReader(const std::string& file) : CapricaBinaryReader(file) { }
+  // Skip function bodies and debug info rather than decoding them, leaving
+  // only what is needed to resolve against the file.
+  bool interfaceOnly { false };
+
+  explicit PexReader(std::string_view buffer) : CapricaBinaryReader(buffer) { }
   PexReader(const PexReader&) = delete;
   ~PexReader() = default;
 
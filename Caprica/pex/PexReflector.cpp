@@ -56,7 +56,7 @@ static PapyrusFunction* reflectFunction(CapricaFileLocation loc,
 }
 
 PapyrusScript* PexReflector::reflectScript(PexFile* pex) {
-  auto alloc = new allocators::ChainedPool(1024 * 4);
+  auto alloc = new allocators::ChainedPool(1024 * 4, MemoryOwner::ScriptAst);
   CapricaFileLocation loc { 0 };
 
   auto script = alloc->make<PapyrusScript>();
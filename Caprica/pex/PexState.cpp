@@ -30,7 +30,7 @@ void PexState::writeAsm(const PexFile* file, const PexObject* obj, PexAsmWriter&
   wtr.ident++;
 
   for (auto f : functions)
-    f->writeAsm(file, obj, this, PexDebugFunctionType::Normal, "", wtr);
+    f->writeAsm(file, obj, this, PexDebugFunctionType::Normal, PexString(), wtr);
 
   wtr.ident--;
   wtr.writeln(".endState");
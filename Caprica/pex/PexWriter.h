@@ -15,10 +15,16 @@
 namespace caprica { namespace pex {
 
 struct PexWriter final : public CapricaBinaryWriter {
-  explicit PexWriter() = default;
+  explicit PexWriter() : CapricaBinaryWriter(MemoryOwner::PexWriter) { }
   PexWriter(const PexWriter&) = delete;
   ~PexWriter() = default;
 
+  void reset() {
+    CapricaBinaryWriter::reset();
+    objectLengthOffset = 0;
+    objectStartSize = 0;
+  }
+
   template <typename T>
   void write(T val) {
     CapricaBinaryWriter::write<T>(std::forward<T>(val));
@@ -69,18 +75,23 @@ struct PexWriter final : public CapricaBinaryWriter {
   }
 
   void beginObject() {
-    objectLength = strm.make<uint32_t>();
-    objectStartSize = strm.totalAllocatedBytes();
+    // The buffer may move as it grows, so remember where the length goes
+    // rather than a pointer to it.
+    objectLengthOffset = size();
+    put<uint32_t>(0);
+    objectStartSize = size();
   }
 
   void endObject() {
-    assert(strm.totalAllocatedBytes() - objectStartSize <= std::numeric_limits<uint32_t>::max());
-    *objectLength = (uint32_t)(strm.totalAllocatedBytes() - objectStartSize);
-    objectLength = nullptr;
+    assert(size() - objectStartSize <= std::numeric_limits<uint32_t>::max());
+    auto len = (uint32_t)(size() - objectStartSize);
+    if (!measuring)
+      memcpy(buffer + objectLengthOffset, &len, sizeof(len));
+    objectLengthOffset = 0;
   }
 
 private:
-  uint32_t* objectLength { nullptr };
+  size_t objectLengthOffset { 0 };
   size_t objectStartSize { 0 };
 };
 
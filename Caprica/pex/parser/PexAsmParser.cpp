@@ -7,8 +7,9 @@
 namespace caprica { namespace pex { namespace parser {
 
 PexFile* PexAsmParser::parseFile() {
-  alloc = new allocators::ChainedPool(1024 * 4);
+  alloc = new allocators::ChainedPool(1024 * 4, MemoryOwner::PexFile);
   auto file = alloc->make<PexFile>(alloc);
+  file->reportingContext = &reportingContext;
 
   while (cur.type != TokenType::END) {
     switch (cur.type) {
@@ -259,7 +260,7 @@ PexFile* PexAsmParser::parseFile() {
                               funcName.c_str());
                         }
                         if (debInf)
-                          file->debugInfo->functions.push_back(debInf);
+                          file->debugInfo->addFunction(debInf);
                         break;
                       }
                       default:
@@ -354,7 +355,7 @@ PexFile* PexAsmParser::parseFile() {
                     func->name = file->getString(funcName);
                     if (debInf) {
                       debInf->functionName = func->name;
-                      file->debugInfo->functions.push_back(debInf);
+                      file->debugInfo->addFunction(debInf);
                     }
                     state->functions.push_back(func);
                   }
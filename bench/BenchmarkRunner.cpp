@@ -0,0 +1,80 @@
+#include "BenchmarkRunner.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+
+namespace caprica { namespace bench {
+
+void BenchmarkRunner::run(const std::string& name,
+                          size_t itemsPerIteration,
+                          const std::function<void()>& body,
+                          const std::function<void()>& setup) {
+  for (size_t i = 0; i < warmupIterations; i++) {
+    if (setup)
+      setup();
+    body();
+  }
+
+  std::vector<double> times {};
+  times.reserve(iterations);
+  for (size_t i = 0; i < iterations; i++) {
+    if (setup)
+      setup();
+    auto start = std::chrono::steady_clock::now();
+    body();
+    auto end = std::chrono::steady_clock::now();
+    times.push_back(std::chrono::duration<double, std::nano>(end - start).count());
+  }
+
+  BenchmarkResult res {};
+  res.name = name;
+  res.iterations = iterations;
+  res.itemsPerIteration = itemsPerIteration;
+  if (!times.empty()) {
+    std::sort(times.begin(), times.end());
+    res.minNanoseconds = times.front();
+    res.medianNanoseconds = times[times.size() / 2];
+    for (auto t : times)
+      res.meanNanoseconds += t;
+    res.meanNanoseconds /= times.size();
+  }
+  std::cout << name << ": median " << (res.medianNanoseconds / 1000000) << "ms" << std::endl;
+  results.push_back(std::move(res));
+}
+
+void BenchmarkRunner::printResults() const {
+  std::printf("%-40s %12s %12s %12s %14s\n", "Benchmark", "Min (ms)", "Median (ms)", "Mean (ms)", "ns/item");
+  for (auto& r : results) {
+    std::printf("%-40s %12.3f %12.3f %12.3f %14.1f\n",
+                r.name.c_str(),
+                r.minNanoseconds / 1000000,
+                r.medianNanoseconds / 1000000,
+                r.meanNanoseconds / 1000000,
+                r.itemsPerIteration ? r.medianNanoseconds / r.itemsPerIteration : 0.0);
+  }
+}
+
+void BenchmarkRunner::writeJson(const std::string& path) const {
+  std::ofstream strm(path, std::ofstream::binary);
+  strm.exceptions(std::ofstream::badbit | std::ofstream::failbit);
+  strm << "{\n  \"benchmarks\": [";
+  bool first = true;
+  for (auto& r : results) {
+    strm << (first ? "\n    {" : ",\n    {");
+    first = false;
+    // Benchmark names are plain identifiers, so they don't need escaping.
+    strm << "\"name\": \"" << r.name << "\"";
+    strm << ", \"iterations\": " << r.iterations;
+    strm << ", \"itemsPerIteration\": " << r.itemsPerIteration;
+    strm << ", \"minNs\": " << (uint64_t)r.minNanoseconds;
+    strm << ", \"medianNs\": " << (uint64_t)r.medianNanoseconds;
+    strm << ", \"meanNs\": " << (uint64_t)r.meanNanoseconds;
+    strm << "}";
+  }
+  strm << "\n  ]\n}\n";
+}
+
+}}
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace caprica { namespace bench {
+
+struct BenchmarkResult final {
+  std::string name {};
+  size_t iterations { 0 };
+  // How many items (tokens, files, lookups, ...) each iteration processes.
+  size_t itemsPerIteration { 0 };
+  double minNanoseconds { 0 };
+  double medianNanoseconds { 0 };
+  double meanNanoseconds { 0 };
+};
+
+struct BenchmarkRunner final {
+  size_t iterations { 10 };
+  size_t warmupIterations { 1 };
+  std::vector<BenchmarkResult> results {};
+
+  // Runs `body` for the warmup iterations and then the timed ones. If given,
+  // `setup` runs before each iteration, outside of the timed region.
+  void run(const std::string& name,
+           size_t itemsPerIteration,
+           const std::function<void()>& body,
+           const std::function<void()>& setup = nullptr);
+
+  void printResults() const;
+  void writeJson(const std::string& path) const;
+};
+
+}}
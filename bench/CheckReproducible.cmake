@@ -0,0 +1,73 @@
+# Checks that --reproducible output doesn't depend on how the compile was scheduled,
+# by compiling the same synthetic corpus serially and in parallel, from two
+# different directories, and comparing the hashes of every .pex file written.
+#
+# Run with cmake -P, passing CAPRICA, CORPUSGEN, GAME and WORK_DIR. FUNCTIONS sets
+# how many functions each script has; scripts with enough of them have their
+# functions built on several threads and merged, which is checked against
+# building them on one.
+
+foreach (var CAPRICA CORPUSGEN GAME WORK_DIR)
+  if (NOT DEFINED ${var})
+    message(FATAL_ERROR "${var} must be set.")
+  endif()
+endforeach()
+
+if (NOT DEFINED FUNCTIONS)
+  set(FUNCTIONS 8)
+endif()
+
+file(REMOVE_RECURSE "${WORK_DIR}")
+
+# The sources are generated twice, so that the directory they were compiled
+# from is covered too.
+foreach (run serial parallel)
+  execute_process(
+    COMMAND "${CORPUSGEN}" -g ${GAME} --files 60 --namespaces 3 --functions ${FUNCTIONS} -o "${WORK_DIR}/${run}/corpus"
+    RESULT_VARIABLE result
+    OUTPUT_QUIET
+  )
+  if (NOT result EQUAL 0)
+    message(FATAL_ERROR "Generating the ${run} corpus failed: ${result}")
+  endif()
+endforeach()
+
+set(serialArgs "")
+set(parallelArgs "-p")
+foreach (run serial parallel)
+  execute_process(
+    COMMAND "${CAPRICA}" -g ${GAME} -q -r --reproducible ${${run}Args}
+            -i "${WORK_DIR}/${run}/corpus/base" -o "${WORK_DIR}/${run}/output" "${WORK_DIR}/${run}/corpus/scripts"
+    RESULT_VARIABLE result
+    OUTPUT_VARIABLE output
+    ERROR_VARIABLE output
+  )
+  if (NOT result EQUAL 0)
+    message(FATAL_ERROR "The ${run} compile failed: ${result}\n${output}")
+  endif()
+endforeach()
+
+file(GLOB_RECURSE serialFiles RELATIVE "${WORK_DIR}/serial/output" "${WORK_DIR}/serial/output/*.pex")
+file(GLOB_RECURSE parallelFiles RELATIVE "${WORK_DIR}/parallel/output" "${WORK_DIR}/parallel/output/*.pex")
+list(SORT serialFiles)
+list(SORT parallelFiles)
+if (NOT serialFiles STREQUAL parallelFiles)
+  message(FATAL_ERROR "The serial and parallel compiles wrote different files.")
+endif()
+list(LENGTH serialFiles fileCount)
+if (fileCount EQUAL 0)
+  message(FATAL_ERROR "No .pex files were written.")
+endif()
+
+set(mismatches "")
+foreach (f ${serialFiles})
+  file(SHA256 "${WORK_DIR}/serial/output/${f}" serialHash)
+  file(SHA256 "${WORK_DIR}/parallel/output/${f}" parallelHash)
+  if (NOT serialHash STREQUAL parallelHash)
+    list(APPEND mismatches "${f}")
+  endif()
+endforeach()
+if (mismatches)
+  message(FATAL_ERROR "The serial and parallel compiles differ in: ${mismatches}")
+endif()
+message(STATUS "All ${fileCount} files are identical.")
@@ -0,0 +1,286 @@
+#include "SyntheticCorpus.h"
+
+#include <filesystem>
+#include <fstream>
+#include <utility>
+#include <vector>
+
+namespace caprica { namespace bench {
+
+// Fallout 4 and later have ScriptObject as the implicit base of every
+// script, and the corpus is compiled without the game's sources, so we
+// provide a stand-in for it. Skyrim's equivalent is one of Caprica's
+// own fake scripts, so nothing is needed there.
+constexpr const char* FAKE_SCRIPTOBJECT_SCRIPT =
+    R"(Scriptname ScriptObject Native
+
+String Function GetState() Native
+Function GotoState(String asNewState) Native
+
+Event OnInit()
+EndEvent
+
+Event OnBeginState(String asOldState)
+EndEvent
+
+Event OnEndState(String asNewState)
+EndEvent
+)";
+
+static std::vector<std::pair<const char*, const char*>> fakeBaseScripts(GameID game) {
+  if (game == GameID::Skyrim)
+    return {};
+  return {
+    {"ScriptObject.psc", FAKE_SCRIPTOBJECT_SCRIPT}
+  };
+}
+
+static bool hasNamespaces(const SyntheticCorpusOptions& opts) {
+  return opts.game != GameID::Skyrim && opts.namespaceCount != 0;
+}
+
+static std::string namespaceName(const SyntheticCorpusOptions& opts, size_t index) {
+  return "BenchNS" + std::to_string(index % opts.namespaceCount);
+}
+
+std::string SyntheticCorpus::scriptName(size_t index) {
+  return "BenchScript" + std::to_string(index);
+}
+
+std::string SyntheticCorpus::qualifiedName(const SyntheticCorpusOptions& opts, size_t index) {
+  if (!hasNamespaces(opts))
+    return scriptName(index);
+  return namespaceName(opts, index) + ":" + scriptName(index);
+}
+
+std::string SyntheticCorpus::relativePath(const SyntheticCorpusOptions& opts, size_t index) {
+  auto file = std::filesystem::path(scriptName(index) + ".psc");
+  if (!hasNamespaces(opts))
+    return file.string();
+  return (std::filesystem::path(namespaceName(opts, index)) / file).string();
+}
+
+static std::string functionName(size_t index, size_t func) {
+  return "Work" + std::to_string(index) + "_" + std::to_string(func);
+}
+
+namespace {
+
+enum class StatementKind {
+  Arithmetic,
+  If,
+  FloatLocal,
+  While,
+  SiblingCall,
+  ParentCall,
+  Array,
+  Struct,
+  Guard,
+};
+
+}
+
+static void generateStatement(std::string& out,
+                              const SyntheticCorpusOptions& opts,
+                              StatementKind kind,
+                              size_t index,
+                              size_t func,
+                              size_t stmt) {
+  auto idx = std::to_string(index);
+  auto sn = std::to_string(stmt);
+  bool hasParent = index % opts.inheritanceDepth != 0;
+  switch (kind) {
+    case StatementKind::Arithmetic:
+      out += "  total += a * " + std::to_string(stmt + 1) + "\n";
+      return;
+    case StatementKind::If:
+      out += "  If total > " + std::to_string(stmt * 7) + "\n";
+      out += "    total -= b as Int\n";
+      out += "  ElseIf total < 0\n";
+      out += "    total = -total\n";
+      out += "  EndIf\n";
+      return;
+    case StatementKind::FloatLocal:
+      out += "  Float f" + sn + " = b * " + sn + ".5\n";
+      out += "  total += f" + sn + " as Int\n";
+      return;
+    case StatementKind::While:
+      out += "  While k < " + std::to_string(stmt + 2) + "\n";
+      out += "    k += 1\n";
+      out += "    total += k\n";
+      out += "  EndWhile\n";
+      return;
+    case StatementKind::SiblingCall:
+      if (func > 0)
+        out += "  total = " + functionName(index, func - 1) + "(total, b)\n";
+      else
+        out += "  counter" + idx + " += 1\n";
+      return;
+    case StatementKind::ParentCall:
+      if (hasParent)
+        out += "  total += " + functionName(index - 1, 0) + "(a, b)\n";
+      else if (opts.propertiesPerScript > 0)
+        out += "  total += Value" + idx + "_0\n";
+      else
+        out += "  total += counter" + idx + "\n";
+      return;
+    case StatementKind::Array:
+      out += "  Int[] arr" + sn + " = new Int[4]\n";
+      out += "  arr" + sn + "[0] = total\n";
+      out += "  total += arr" + sn + ".Length\n";
+      return;
+    case StatementKind::Struct:
+      out += "  Point" + idx + "_0 p" + sn + " = new Point" + idx + "_0\n";
+      out += "  p" + sn + ".x = total\n";
+      out += "  total += p" + sn + ".x\n";
+      return;
+    case StatementKind::Guard:
+      out += "  Guard Lock" + idx + "_0\n";
+      out += "    counter" + idx + " += 1\n";
+      out += "  EndGuard\n";
+      return;
+  }
+}
+
+static void generateProperty(std::string& out, size_t index, size_t prop) {
+  auto idx = std::to_string(index);
+  auto pn = idx + "_" + std::to_string(prop);
+  switch (prop % 3) {
+    case 0:
+      out += "Int Property Value" + pn + " Auto\n";
+      return;
+    case 1:
+      out += "Float Property Scale" + pn + " = 1.5 AutoReadOnly\n";
+      return;
+    case 2:
+      out += "Int Property Level" + pn + "\n";
+      out += "  Int Function Get()\n";
+      out += "    Return counter" + idx + "\n";
+      out += "  EndFunction\n";
+      out += "  Function Set(Int value)\n";
+      out += "    counter" + idx + " = value\n";
+      out += "  EndFunction\n";
+      out += "EndProperty\n";
+      return;
+  }
+}
+
+std::string SyntheticCorpus::generateScript(const SyntheticCorpusOptions& opts, size_t index) {
+  auto o = opts;
+  if (o.inheritanceDepth == 0)
+    o.inheritanceDepth = 1;
+  bool hasParent = index % o.inheritanceDepth != 0;
+  bool canUseStructs = o.game != GameID::Skyrim && o.structsPerScript > 0;
+  bool canUseGuards = o.game == GameID::Starfield && o.guardsPerScript > 0;
+  auto idx = std::to_string(index);
+
+  std::string out;
+  out += "Scriptname " + qualifiedName(o, index);
+  if (hasParent)
+    out += " Extends " + qualifiedName(o, index - 1);
+  out += "\n\n";
+  out += "Int counter" + idx + " = 0\n";
+
+  if (o.propertiesPerScript > 0) {
+    out += "\n";
+    if (o.game != GameID::Skyrim)
+      out += "Group Properties" + idx + "\n";
+    for (size_t p = 0; p < o.propertiesPerScript; p++)
+      generateProperty(out, index, p);
+    if (o.game != GameID::Skyrim)
+      out += "EndGroup\n";
+  }
+
+  if (canUseStructs) {
+    for (size_t s = 0; s < o.structsPerScript; s++) {
+      out += "\n";
+      out += "Struct Point" + idx + "_" + std::to_string(s) + "\n";
+      out += "  Int x = 0\n";
+      out += "  Float y = 1.0\n";
+      out += "  String label\n";
+      out += "EndStruct\n";
+    }
+  }
+
+  if (canUseGuards) {
+    out += "\n";
+    for (size_t g = 0; g < o.guardsPerScript; g++)
+      out += "Guard Lock" + idx + "_" + std::to_string(g) + "\n";
+  }
+
+  out += "\n";
+  out += "Int Function Helper" + idx + "(Int a) Global\n";
+  out += "  Return a * 2 + 1\n";
+  out += "EndFunction\n";
+
+  std::vector<StatementKind> kinds {
+    StatementKind::Arithmetic,  StatementKind::If,         StatementKind::FloatLocal,
+    StatementKind::While,       StatementKind::SiblingCall, StatementKind::ParentCall,
+    StatementKind::Array,
+  };
+  if (canUseStructs)
+    kinds.push_back(StatementKind::Struct);
+  if (canUseGuards)
+    kinds.push_back(StatementKind::Guard);
+
+  for (size_t f = 0; f < o.functionsPerScript; f++) {
+    out += "\n";
+    out += "Int Function " + functionName(index, f) + "(Int a, Float b)\n";
+    out += "  Int total = a\n";
+    out += "  Int k = 0\n";
+    for (size_t s = 0; s < o.statementsPerFunction; s++)
+      generateStatement(out, o, kinds[s % kinds.size()], index, f, s);
+    // Only call scripts earlier in the corpus, so that the
+    // dependencies between scripts never form a cycle.
+    if (index > 0) {
+      for (size_t c = 0; c < o.crossScriptCallsPerFunction; c++) {
+        auto target = (index * 31 + f * 7 + c) % index;
+        out += "  total += " + qualifiedName(o, target) + ".Helper" + std::to_string(target) + "(a)\n";
+      }
+    }
+    out += "  Return total\n";
+    out += "EndFunction\n";
+  }
+
+  if (o.statesPerScript > 0) {
+    out += "\n";
+    out += "Function Enter" + idx + "()\n";
+    out += "  GotoState(\"Busy" + idx + "_0\")\n";
+    out += "EndFunction\n";
+    for (size_t s = 0; s < o.statesPerScript; s++) {
+      out += "\n";
+      out += "State Busy" + idx + "_" + std::to_string(s) + "\n";
+      if (o.functionsPerScript > 0) {
+        out += "  Int Function " + functionName(index, 0) + "(Int a, Float b)\n";
+        out += "    Return a\n";
+        out += "  EndFunction\n";
+      }
+      out += "EndState\n";
+    }
+  }
+  return out;
+}
+
+static void writeFile(const std::filesystem::path& path, const std::string& contents) {
+  std::ofstream strm(path, std::ofstream::binary);
+  strm.exceptions(std::ofstream::badbit | std::ofstream::failbit);
+  strm.write(contents.data(), contents.size());
+}
+
+void SyntheticCorpus::write(const SyntheticCorpusOptions& opts, const std::string& directory) {
+  auto baseDir = std::filesystem::path(directory) / "base";
+  auto scriptsDir = std::filesystem::path(directory) / "scripts";
+  std::filesystem::create_directories(baseDir);
+  std::filesystem::create_directories(scriptsDir);
+
+  for (auto& base : fakeBaseScripts(opts.game))
+    writeFile(baseDir / base.first, base.second);
+  if (hasNamespaces(opts)) {
+    for (size_t n = 0; n < opts.namespaceCount && n < opts.fileCount; n++)
+      std::filesystem::create_directories(scriptsDir / namespaceName(opts, n));
+  }
+  for (size_t i = 0; i < opts.fileCount; i++)
+    writeFile(scriptsDir / relativePath(opts, i), generateScript(opts, i));
+}
+
+}}
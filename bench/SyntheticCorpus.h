@@ -0,0 +1,44 @@
+#pragma once
+
+#include <string>
+
+#include <common/GameID.h>
+
+namespace caprica { namespace bench {
+
+struct SyntheticCorpusOptions final {
+  GameID game { GameID::Fallout4 };
+  size_t fileCount { 200 };
+  // The longest chain of scripts extending each other.
+  size_t inheritanceDepth { 4 };
+  // The number of namespaces to spread the scripts over. Ignored for Skyrim.
+  size_t namespaceCount { 0 };
+  size_t functionsPerScript { 8 };
+  size_t statementsPerFunction { 16 };
+  size_t propertiesPerScript { 3 };
+  // Ignored for Skyrim.
+  size_t structsPerScript { 1 };
+  size_t statesPerScript { 1 };
+  // Only used for Starfield.
+  size_t guardsPerScript { 1 };
+  // Calls to global functions of other scripts, made from each function.
+  size_t crossScriptCallsPerFunction { 1 };
+};
+
+// Generates a tree of valid Papyrus scripts for benchmarking,
+// so that we don't need to ship game sources to measure the compiler.
+struct SyntheticCorpus final {
+  static std::string scriptName(size_t index);
+  // The name including the namespace, as used to refer to the script.
+  static std::string qualifiedName(const SyntheticCorpusOptions& opts, size_t index);
+  // The path of the script, relative to the scripts directory.
+  static std::string relativePath(const SyntheticCorpusOptions& opts, size_t index);
+  static std::string generateScript(const SyntheticCorpusOptions& opts, size_t index);
+
+  // Writes the fake base scripts the corpus depends on to `directory`\base,
+  // and the corpus itself to `directory`\scripts. The scripts directory is
+  // compiled recursively, importing the base directory.
+  static void write(const SyntheticCorpusOptions& opts, const std::string& directory);
+};
+
+}}
@@ -0,0 +1,87 @@
+#include <boost/program_options.hpp>
+
+#include <iostream>
+#include <string>
+
+#include <common/GameID.h>
+
+#include "../SyntheticCorpus.h"
+
+namespace po = boost::program_options;
+
+int main(int argc, char* argv[]) {
+  caprica::bench::SyntheticCorpusOptions opts {};
+  std::string outputDirectory {};
+
+  try {
+    po::options_description desc("Synthetic Papyrus corpus generator");
+    desc.add_options()("help,h", "Print usage information.")(
+        "game,g",
+        po::value<std::string>()->default_value("fallout4"),
+        "Set the game to generate scripts for. Valid values are: starfield, skyrim, fallout4, fallout76.")(
+        "output,o",
+        po::value<std::string>(&outputDirectory)->default_value("caprica_corpus"),
+        "The directory to write the corpus to.")(
+        "files", po::value<size_t>(&opts.fileCount)->default_value(opts.fileCount), "The number of scripts.")(
+        "inheritance-depth",
+        po::value<size_t>(&opts.inheritanceDepth)->default_value(opts.inheritanceDepth),
+        "The longest chain of scripts extending each other.")(
+        "namespaces",
+        po::value<size_t>(&opts.namespaceCount)->default_value(opts.namespaceCount),
+        "The number of namespaces to spread the scripts over.")(
+        "functions",
+        po::value<size_t>(&opts.functionsPerScript)->default_value(opts.functionsPerScript),
+        "The number of functions in each script.")(
+        "statements",
+        po::value<size_t>(&opts.statementsPerFunction)->default_value(opts.statementsPerFunction),
+        "The number of statements in each function.")(
+        "properties",
+        po::value<size_t>(&opts.propertiesPerScript)->default_value(opts.propertiesPerScript),
+        "The number of properties in each script.")(
+        "structs",
+        po::value<size_t>(&opts.structsPerScript)->default_value(opts.structsPerScript),
+        "The number of structs in each script.")(
+        "states",
+        po::value<size_t>(&opts.statesPerScript)->default_value(opts.statesPerScript),
+        "The number of named states in each script.")(
+        "guards",
+        po::value<size_t>(&opts.guardsPerScript)->default_value(opts.guardsPerScript),
+        "The number of guards in each script.")(
+        "cross-calls",
+        po::value<size_t>(&opts.crossScriptCallsPerFunction)->default_value(opts.crossScriptCallsPerFunction),
+        "The number of calls to other scripts made from each function.");
+
+    po::variables_map vm;
+    po::store(po::parse_command_line(argc, argv, desc), vm);
+    po::notify(vm);
+    if (vm.count("help")) {
+      std::cout << desc << std::endl;
+      return 0;
+    }
+
+    std::string gameType = vm["game"].as<std::string>();
+    if (_stricmp(gameType.c_str(), "Starfield") == 0) {
+      opts.game = caprica::GameID::Starfield;
+    } else if (_stricmp(gameType.c_str(), "Skyrim") == 0) {
+      opts.game = caprica::GameID::Skyrim;
+    } else if (_stricmp(gameType.c_str(), "Fallout4") == 0) {
+      opts.game = caprica::GameID::Fallout4;
+    } else if (_stricmp(gameType.c_str(), "Fallout76") == 0) {
+      opts.game = caprica::GameID::Fallout76;
+    } else {
+      std::cout << "Unrecognized game type '" << gameType << "'!" << std::endl;
+      return -1;
+    }
+
+    caprica::bench::SyntheticCorpus::write(opts, outputDirectory);
+    std::cout << "Wrote " << opts.fileCount << " scripts to '" << outputDirectory << "'. Compile them with:"
+              << std::endl;
+    std::cout << "  Caprica -g " << gameType << " -r -i " << outputDirectory << "\\base " << outputDirectory
+              << "\\scripts" << std::endl;
+  } catch (const std::exception& ex) {
+    if (ex.what() != std::string(""))
+      std::cout << ex.what() << std::endl;
+    return -1;
+  }
+  return 0;
+}
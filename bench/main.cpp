@@ -0,0 +1,300 @@
+#include <boost/program_options.hpp>
+
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#include <common/allocators/ReffyStringPool.h>
+#include <common/CapricaConfig.h>
+#include <common/CapricaReportingContext.h>
+#include <common/CaselessStringComparer.h>
+
+#include <papyrus/parser/PapyrusLexer.h>
+#include <papyrus/parser/PapyrusParser.h>
+
+#include <pex/PexFile.h>
+#include <pex/PexOptimizer.h>
+#include <pex/PexReader.h>
+#include <pex/PexWriter.h>
+
+#include "BenchmarkRunner.h"
+#include "SyntheticCorpus.h"
+
+namespace conf = caprica::conf;
+namespace po = boost::program_options;
+namespace filesystem = std::filesystem;
+
+namespace caprica { namespace bench {
+
+namespace {
+
+struct LexAllTokens final : private papyrus::parser::PapyrusLexer {
+  explicit LexAllTokens(CapricaReportingContext& repCtx, const std::string& file, std::string_view data)
+      : PapyrusLexer(repCtx, file, data) { }
+  LexAllTokens(const LexAllTokens&) = delete;
+  ~LexAllTokens() { delete alloc; }
+
+  size_t run() {
+    size_t count = 1;
+    while (cur.type != papyrus::parser::TokenType::END) {
+      consume();
+      count++;
+    }
+    return count;
+  }
+};
+
+struct CorpusFile final {
+  std::string path {};
+  std::string text {};
+};
+
+// Keeps the optimizer from throwing away work whose result isn't otherwise used.
+volatile size_t benchmarkSink { 0 };
+
+void benchmarkFrontend(BenchmarkRunner& runner, const std::vector<CorpusFile>& files) {
+  size_t tokenCount = 0;
+  for (auto& f : files) {
+    CapricaReportingContext ctx { f.path };
+    tokenCount += LexAllTokens(ctx, f.path, f.text).run();
+  }
+
+  runner.run("PapyrusLexer", tokenCount, [&] {
+    size_t n = 0;
+    for (auto& f : files) {
+      CapricaReportingContext ctx { f.path };
+      n += LexAllTokens(ctx, f.path, f.text).run();
+    }
+    benchmarkSink = n;
+  });
+
+  runner.run("PapyrusParser::parseScript", files.size(), [&] {
+    for (auto& f : files) {
+      CapricaReportingContext ctx { f.path };
+      papyrus::parser::PapyrusParser parser { ctx, f.path, f.text };
+      // The script lives in its own pool, which also runs its destructor.
+      delete parser.parseScript()->allocator;
+    }
+  });
+}
+
+void benchmarkIdentifiers(BenchmarkRunner& runner, const SyntheticCorpusOptions& opts) {
+  std::vector<std::string> names {};
+  for (size_t i = 0; i < opts.fileCount; i++) {
+    auto idx = std::to_string(i);
+    names.push_back(SyntheticCorpus::scriptName(i));
+    names.push_back("counter" + idx);
+    names.push_back("Helper" + idx);
+    for (size_t f = 0; f < opts.functionsPerScript; f++)
+      names.push_back("Work" + idx + "_" + std::to_string(f));
+  }
+  std::vector<std::string> upperNames {};
+  upperNames.reserve(names.size());
+  for (auto& n : names) {
+    auto u = n;
+    std::transform(u.begin(), u.end(), u.begin(), [](unsigned char c) { return (char)std::toupper(c); });
+    upperNames.push_back(std::move(u));
+  }
+
+  runner.run("CaselessIdentifierEqual", names.size(), [&] {
+    size_t n = 0;
+    for (size_t i = 0; i < names.size(); i++)
+      n += CaselessIdentifierEqual::equal<true>(names[i].data(), upperNames[i].data(), names[i].size());
+    benchmarkSink = n;
+  });
+
+  // Each name is looked up twice, once to insert it and once to find it again.
+  auto lookupCount = std::min(names.size(), allocators::ReffyStringPool::MaxCapacity);
+  allocators::ReffyStringPool pool {};
+  runner.run(
+      "ReffyStringPool",
+      lookupCount * 2,
+      [&] {
+        size_t n = 0;
+        for (size_t i = 0; i < lookupCount; i++)
+          n += pool.lookup(names[i]);
+        for (size_t i = 0; i < lookupCount; i++)
+          n += pool.lookup(names[i]);
+        benchmarkSink = n;
+      },
+      [&] { pool.reset(); });
+}
+
+void benchmarkPex(BenchmarkRunner& runner, const std::string& pexDirectory) {
+  std::vector<std::string> pexFiles {};
+  for (auto& e : filesystem::recursive_directory_iterator(pexDirectory)) {
+    if (e.path().extension() == ".pex")
+      pexFiles.push_back(e.path().string());
+  }
+  if (pexFiles.empty()) {
+    std::cout << "No .pex files in '" << pexDirectory << "', skipping the Pex benchmarks." << std::endl;
+    return;
+  }
+
+  // The files are loaded up front, as the compiler's read job would,
+  // so that only decoding them is measured.
+  std::vector<std::string> pexData {};
+  pexData.reserve(pexFiles.size());
+  for (auto& f : pexFiles) {
+    std::ifstream strm { f, std::ifstream::binary };
+    strm.exceptions(std::ifstream::badbit | std::ifstream::failbit);
+    pexData.emplace_back(std::istreambuf_iterator<char>(strm), std::istreambuf_iterator<char>());
+  }
+
+  std::vector<pex::PexFile*> loaded {};
+  const auto readAll = [&] {
+    for (auto& data : pexData) {
+      pex::PexReader rdr { data };
+      loaded.push_back(pex::PexFile::read(new allocators::ChainedPool(1024 * 4), rdr));
+    }
+  };
+  const auto freeAll = [&] {
+    for (auto f : loaded)
+      delete f->alloc;
+    loaded.clear();
+  };
+
+  runner.run("PexFile::read", pexFiles.size(), readAll, freeAll);
+
+  pex::PexWriter wtr {};
+  runner.run(
+      "PexFile::write",
+      pexFiles.size(),
+      [&] {
+        for (auto f : loaded) {
+          wtr.reset();
+          f->write(wtr);
+        }
+      },
+      [&] {
+        if (loaded.empty())
+          readAll();
+      });
+
+  // The optimizer modifies the file in place, so each iteration
+  // has to start from a freshly read copy.
+  runner.run(
+      "PexOptimizer",
+      pexFiles.size(),
+      [&] {
+        for (auto f : loaded)
+          pex::PexOptimizer::optimize(f);
+      },
+      [&] {
+        freeAll();
+        readAll();
+      });
+  freeAll();
+}
+
+void benchmarkEndToEnd(BenchmarkRunner& runner,
+                       const SyntheticCorpusOptions& opts,
+                       const std::string& compilerPath,
+                       const std::string& corpusDirectory,
+                       const std::string& outputDirectory) {
+  auto base = (filesystem::path(corpusDirectory) / "base").string();
+  auto scripts = (filesystem::path(corpusDirectory) / "scripts").string();
+  // cmd.exe strips the outermost pair of quotes, so the whole
+  // command has to be wrapped in another pair.
+  auto cmd = "\"\"" + compilerPath + "\" -g " + GameIDToString(opts.game) + " -q -p -r -i \"" + base + "\" -o \"" +
+             outputDirectory + "\" \"" + scripts + "\"\"";
+  bool failed = false;
+  runner.run("EndToEnd", opts.fileCount, [&] {
+    if (std::system(cmd.c_str()) != 0)
+      failed = true;
+  });
+  if (failed)
+    std::cout << "WARNING: The compiler reported a failure while compiling the corpus!" << std::endl;
+}
+
+}
+
+}}
+
+int main(int argc, char* argv[]) {
+  caprica::bench::SyntheticCorpusOptions corpusOpts {};
+  caprica::bench::BenchmarkRunner runner {};
+  std::string corpusDirectory {};
+  std::string compilerPath {};
+  std::string jsonPath {};
+
+  try {
+    po::options_description desc("Caprica benchmarks");
+    desc.add_options()("help,h", "Print usage information.")(
+        "files",
+        po::value<size_t>(&corpusOpts.fileCount)->default_value(corpusOpts.fileCount),
+        "The number of scripts in the synthetic corpus.")(
+        "inheritance-depth",
+        po::value<size_t>(&corpusOpts.inheritanceDepth)->default_value(corpusOpts.inheritanceDepth),
+        "The longest chain of scripts extending each other.")(
+        "functions",
+        po::value<size_t>(&corpusOpts.functionsPerScript)->default_value(corpusOpts.functionsPerScript),
+        "The number of functions in each script.")(
+        "statements",
+        po::value<size_t>(&corpusOpts.statementsPerFunction)->default_value(corpusOpts.statementsPerFunction),
+        "The number of statements in each function.")(
+        "iterations",
+        po::value<size_t>(&runner.iterations)->default_value(runner.iterations),
+        "The number of timed iterations of each benchmark.")(
+        "corpus-dir",
+        po::value<std::string>(&corpusDirectory)->default_value("caprica_bench_corpus"),
+        "The directory to generate the corpus in.")(
+        "compiler",
+        po::value<std::string>(&compilerPath)->default_value(CAPRICA_BENCH_DEFAULT_COMPILER),
+        "The Caprica executable to run the end-to-end benchmark with. Pass an empty string to skip it.")(
+        "json", po::value<std::string>(&jsonPath), "Write the results as JSON to the given file.");
+
+    po::variables_map vm;
+    po::store(po::parse_command_line(argc, argv, desc), vm);
+    po::notify(vm);
+    if (vm.count("help")) {
+      std::cout << desc << std::endl;
+      return 0;
+    }
+  } catch (const std::exception& ex) {
+    std::cout << ex.what() << std::endl;
+    return -1;
+  }
+
+  conf::Papyrus::game = corpusOpts.game;
+  conf::General::quietCompile = true;
+
+  try {
+    std::cout << "Generating " << corpusOpts.fileCount << " scripts in '" << corpusDirectory << "'..." << std::endl;
+    caprica::bench::SyntheticCorpus::write(corpusOpts, corpusDirectory);
+
+    std::vector<caprica::bench::CorpusFile> files {};
+    files.reserve(corpusOpts.fileCount);
+    for (size_t i = 0; i < corpusOpts.fileCount; i++) {
+      auto path = caprica::bench::SyntheticCorpus::relativePath(corpusOpts, i);
+      files.push_back({ (filesystem::path(corpusDirectory) / "scripts" / path).string(),
+                        caprica::bench::SyntheticCorpus::generateScript(corpusOpts, i) });
+    }
+
+    caprica::bench::benchmarkFrontend(runner, files);
+    caprica::bench::benchmarkIdentifiers(runner, corpusOpts);
+
+    // The Pex benchmarks run over the end-to-end benchmark's output,
+    // as producing a PexFile needs the whole compiler.
+    auto outputDirectory = (filesystem::path(corpusDirectory) / "output").string();
+    if (!compilerPath.empty()) {
+      caprica::bench::benchmarkEndToEnd(runner, corpusOpts, compilerPath, corpusDirectory, outputDirectory);
+      caprica::bench::benchmarkPex(runner, outputDirectory);
+    }
+  } catch (const std::exception& ex) {
+    if (ex.what() != std::string(""))
+      std::cout << ex.what() << std::endl;
+    return -1;
+  }
+
+  runner.printResults();
+  if (!jsonPath.empty())
+    runner.writeJson(jsonPath);
+  return 0;
+}